@@ -0,0 +1,641 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <sys/mman.h>
+
+//The scrolling lesson with its surfaces created by a SurfaceAllocator
+//instead of SDL. Pixels sit on 64 byte aligned rows with the pitch padded
+//to a multiple of 64, so every row starts on a cache line and vector code
+//can use aligned loads. Surfaces of HUGE_PAGE_THRESHOLD or more get their
+//own 2 MB aligned mapping, marked MADV_HUGEPAGE so the kernel can back it
+//with transparent huge pages. The 1280x960 background then needs a few TLB
+//entries instead of over a thousand. The surfaces are wrapped with
+//SDL_CreateRGBSurfaceFrom(), so blitting is unchanged.
+//A switches to the SDL allocated copies to compare; the caption shows the
+//average time of the background blit. Allocations print at startup.
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 20;
+const int LEVEL_WIDTH = 1280;
+const int LEVEL_HEIGHT = 960;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+
+const int SURFACE_ALIGNMENT = 64;
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+//Smaller surfaces share ordinary pages through posix_memalign()
+const size_t HUGE_PAGE_THRESHOLD = HUGE_PAGE_SIZE;
+
+//Globals
+SDL_Surface *dot = NULL;
+SDL_Surface *background = NULL;
+SDL_Surface *sdlDot = NULL;
+SDL_Surface *sdlBackground = NULL;
+SDL_Surface *screen = NULL;
+SDL_Event event;
+SDL_Rect camera = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+
+//Structs/Classes
+struct SurfaceAllocation
+{
+  SDL_Surface *surface;
+  void *memory;
+  size_t size;
+  bool mapped;
+  bool huge;
+};
+
+class SurfaceAllocator
+{
+  private:
+    std::vector<SurfaceAllocation> allocations;
+
+  public:
+    SDL_Surface *create(int w, int h, SDL_PixelFormat *format);
+    SDL_Surface *copy(SDL_Surface *source);
+    void release(SDL_Surface *surface);
+    void release_all();
+    void report(std::ostream &out);
+};
+
+class Dot
+{
+  private:
+    int x, y;
+    int xVel, yVel;
+
+  public:
+    Dot();
+    void handle_input();
+    void move();
+    void show(SDL_Surface *image);
+    void set_camera();
+};
+
+class Timer
+{
+  private:
+    int startTicks;
+    int pausedTicks;
+
+    bool paused;
+    bool started;
+
+  public:
+    Timer();
+    void start();
+    void stop();
+    void pause();
+    void unpause();
+    int get_ticks();
+    bool is_started();
+    bool is_paused();
+};
+
+SurfaceAllocator surfaces;
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *load_image(std::string filename);
+bool load_files();
+void clean_up();
+Sint64 now_nanoseconds();
+long huge_pages_kb(void *address);
+
+//Functions
+int main(int argc, char* args[])
+{
+  bool quit = false;
+  bool aligned = true;
+  Sint64 blitTime = 0;
+  int frame = 0;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  surfaces.report(std::cout);
+
+  Timer fps;
+  Dot myDot;
+
+  while(quit == false)
+  {
+    fps.start();
+
+    while(SDL_PollEvent(&event))
+    {
+      myDot.handle_input();
+
+      if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_a))
+      {
+        aligned = !aligned;
+        blitTime = 0;
+        frame = 0;
+      }
+
+      if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    myDot.move();
+    myDot.set_camera();
+
+    Sint64 start = now_nanoseconds();
+    apply_surface(0, 0, aligned ? background : sdlBackground, screen, &camera);
+    blitTime += now_nanoseconds() - start;
+
+    myDot.show(aligned ? dot : sdlDot);
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    frame++;
+
+    if(frame % FRAMES_PER_SECOND == 0)
+    {
+      std::stringstream caption;
+      caption << (aligned ? "Aligned" : "SDL") << " surfaces, background blit ";
+      caption << blitTime / frame / 1000 << " us";
+
+      SDL_WM_SetCaption(caption.str().c_str(), NULL);
+    }
+
+    if(fps.get_ticks() < 1000 / FRAMES_PER_SECOND)
+    {
+      SDL_Delay((1000 / FRAMES_PER_SECOND) - fps.get_ticks());
+    }
+  }
+
+  clean_up();
+  return 0;
+}
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+long huge_pages_kb(void *address)
+{
+  //Find the mapping holding address and read how much of it is huge pages
+  std::ifstream smaps("/proc/self/smaps");
+  std::string line;
+  bool inside = false;
+  unsigned long target = (unsigned long)address;
+
+  while(std::getline(smaps, line))
+  {
+    unsigned long low = 0, high = 0;
+    char dash = 0;
+    std::stringstream range(line);
+
+    //Mapping headers start "low-high perms ..."
+    if((range >> std::hex >> low >> dash >> high) && (dash == '-'))
+    {
+      inside = (target >= low) && (target < high);
+      continue;
+    }
+
+    if((inside == true) && (line.compare(0, 14, "AnonHugePages:") == 0))
+    {
+      return atol(line.c_str() + 14);
+    }
+  }
+
+  return -1;
+}
+
+SDL_Surface *SurfaceAllocator::create(int w, int h, SDL_PixelFormat *format)
+{
+  SurfaceAllocation allocation;
+  int bytes = format->BytesPerPixel;
+  int pitch = (w * bytes + SURFACE_ALIGNMENT - 1) & ~(SURFACE_ALIGNMENT - 1);
+
+  allocation.size = (size_t)pitch * h;
+  allocation.memory = NULL;
+  allocation.mapped = false;
+  allocation.huge = false;
+
+  if(allocation.size >= HUGE_PAGE_THRESHOLD)
+  {
+    //Huge pages need 2 MB aligned ranges; map a spare 2 MB, trim both ends
+    size_t length = (allocation.size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    Uint8 *mapping = (Uint8 *)mmap(NULL, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if(mapping != MAP_FAILED)
+    {
+      Uint8 *start = (Uint8 *)(((unsigned long)mapping + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+      size_t head = start - mapping;
+      size_t tail = HUGE_PAGE_SIZE - head;
+
+      if(head > 0)
+      {
+        munmap(mapping, head);
+      }
+
+      if(tail > 0)
+      {
+        munmap(start + length, tail);
+      }
+
+      allocation.memory = start;
+      allocation.size = length;
+      allocation.mapped = true;
+
+#ifdef MADV_HUGEPAGE
+      allocation.huge = (madvise(start, length, MADV_HUGEPAGE) == 0);
+#endif
+    }
+  }
+
+  //Small surface, or no mapping to be had
+  if(allocation.memory == NULL)
+  {
+    if(posix_memalign(&allocation.memory, SURFACE_ALIGNMENT, allocation.size) != 0)
+    {
+      return NULL;
+    }
+  }
+
+  allocation.surface = SDL_CreateRGBSurfaceFrom(allocation.memory, w, h, format->BitsPerPixel, pitch,
+                                                format->Rmask, format->Gmask, format->Bmask, format->Amask);
+
+  if(allocation.surface == NULL)
+  {
+    if(allocation.mapped == true)
+    {
+      munmap(allocation.memory, allocation.size);
+    }
+    else
+    {
+      free(allocation.memory);
+    }
+
+    return NULL;
+  }
+
+  allocations.push_back(allocation);
+
+  return allocation.surface;
+}
+
+SDL_Surface *SurfaceAllocator::copy(SDL_Surface *source)
+{
+  SDL_Surface *result = create(source->w, source->h, source->format);
+
+  if(result == NULL)
+  {
+    return NULL;
+  }
+
+  //Same format, so rows copy straight across; only the pitch differs
+  int rowBytes = source->w * source->format->BytesPerPixel;
+
+  SDL_LockSurface(source);
+
+  for(int y = 0; y < source->h; y++)
+  {
+    memcpy((Uint8 *)result->pixels + y * result->pitch, (Uint8 *)source->pixels + y * source->pitch, rowBytes);
+  }
+
+  SDL_UnlockSurface(source);
+
+  if((source->flags & SDL_SRCCOLORKEY) != 0)
+  {
+    Uint32 rle = ((source->flags & SDL_RLEACCELOK) != 0) ? SDL_RLEACCEL : 0;
+    SDL_SetColorKey(result, SDL_SRCCOLORKEY | rle, source->format->colorkey);
+  }
+
+  if((source->flags & SDL_SRCALPHA) != 0)
+  {
+    SDL_SetAlpha(result, SDL_SRCALPHA, source->format->alpha);
+  }
+
+  return result;
+}
+
+void SurfaceAllocator::release(SDL_Surface *surface)
+{
+  for(unsigned int a = 0; a < allocations.size(); a++)
+  {
+    if(allocations[a].surface != surface)
+    {
+      continue;
+    }
+
+    //Surfaces made from our memory don't free it themselves
+    SDL_FreeSurface(surface);
+
+    if(allocations[a].mapped == true)
+    {
+      munmap(allocations[a].memory, allocations[a].size);
+    }
+    else
+    {
+      free(allocations[a].memory);
+    }
+
+    allocations.erase(allocations.begin() + a);
+    return;
+  }
+}
+
+void SurfaceAllocator::release_all()
+{
+  while(allocations.empty() == false)
+  {
+    release(allocations.back().surface);
+  }
+}
+
+void SurfaceAllocator::report(std::ostream &out)
+{
+  for(unsigned int a = 0; a < allocations.size(); a++)
+  {
+    SurfaceAllocation &allocation = allocations[a];
+
+    out << allocation.surface->w << "x" << allocation.surface->h;
+    out << " pitch " << allocation.surface->pitch;
+    out << ", " << allocation.size / 1024 << " kB";
+    out << ", " << (((unsigned long)allocation.memory % SURFACE_ALIGNMENT == 0) ? "aligned" : "NOT aligned");
+
+    if(allocation.mapped == true)
+    {
+      out << ", mapped, huge pages " << (allocation.huge ? "requested" : "refused");
+      out << ", " << huge_pages_kb(allocation.memory) << " kB in huge pages";
+    }
+
+    out << std::endl;
+  }
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_VIDEO) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Aligned Surfaces", NULL);
+
+  return true;
+}
+
+bool load_files()
+{
+  //SDL's copies stay loaded for comparison
+  sdlDot = load_image("dot.bmp");
+  sdlBackground = load_image("bg.png");
+
+  if((sdlDot == NULL) || (sdlBackground == NULL))
+  {
+    return false;
+  }
+
+  dot = surfaces.copy(sdlDot);
+  background = surfaces.copy(sdlBackground);
+
+  if((dot == NULL) || (background == NULL))
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  surfaces.release_all();
+
+  SDL_FreeSurface(sdlDot);
+  SDL_FreeSurface(sdlBackground);
+
+  SDL_Quit();
+}
+
+Dot::Dot()
+{
+  x = 0;
+  y = 0;
+  xVel = 0;
+  yVel = 0;
+}
+
+void Dot::handle_input()
+{
+  if(event.type == SDL_KEYDOWN)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel += DOT_WIDTH / 2; break;
+      case SDLK_LEFT: xVel -= DOT_WIDTH / 2; break;
+    }
+  }
+  else if(event.type == SDL_KEYUP)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel -= DOT_WIDTH / 2; break;
+      case SDLK_LEFT: xVel += DOT_WIDTH / 2; break;
+    }
+  }
+}
+
+void Dot::move()
+{
+  x += xVel;
+
+  if((x < 0) || (x + DOT_WIDTH > LEVEL_WIDTH))
+  {
+    x -= xVel;
+  }
+
+  y += yVel;
+
+  if((y < 0) || (y + DOT_HEIGHT > LEVEL_HEIGHT))
+  {
+    y -= yVel;
+  }
+}
+
+void Dot::show(SDL_Surface *image)
+{
+  apply_surface(x - camera.x, y - camera.y, image, screen);
+}
+
+void Dot::set_camera()
+{
+  camera.x = (x + DOT_WIDTH / 2) - SCREEN_WIDTH / 2;
+  camera.y = (y + DOT_HEIGHT / 2) - SCREEN_HEIGHT / 2;
+
+  if(camera.x < 0)
+  {
+    camera.x = 0;
+  }
+
+  if(camera.y < 0)
+  {
+    camera.y = 0;
+  }
+
+  if(camera.x > LEVEL_WIDTH - camera.w)
+  {
+    camera.x = LEVEL_WIDTH - camera.w;
+  }
+
+  if(camera.y > LEVEL_HEIGHT - camera.h)
+  {
+    camera.y = LEVEL_HEIGHT - camera.h;
+  }
+}
+
+Timer::Timer()
+{
+  startTicks = 0;
+  pausedTicks = 0;
+  paused = false;
+  started = false;
+}
+
+void Timer::start()
+{
+  started = true;
+  paused = false;
+  startTicks = SDL_GetTicks();
+}
+
+void Timer::stop()
+{
+  started = false;
+  paused = false;
+}
+
+int Timer::get_ticks()
+{
+  if(started == true)
+  {
+    if(paused == true)
+    {
+      return pausedTicks;
+    }
+    else
+    {
+      return SDL_GetTicks() - startTicks;
+    }
+  }
+  return 0;
+}
+
+void Timer::pause()
+{
+  if((started == true) && (paused == false))
+  {
+    paused = true;
+    pausedTicks = SDL_GetTicks() - startTicks;
+  }
+}
+
+void Timer::unpause()
+{
+  if(paused == true)
+  {
+    paused = false;
+    startTicks = SDL_GetTicks() - pausedTicks;
+    pausedTicks = 0;
+  }
+}
+
+bool Timer::is_started()
+{
+  return started;
+}
+
+bool Timer::is_paused()
+{
+  return paused;
+}
@@ -27,6 +27,9 @@ TTF_Font *font = NULL;
 SDL_Color textColor = {0xFF, 0xFF, 0xFF};
 SDL_Joystick *stick = NULL;
 
+//Whether front alone paints every pixel of the screen when opaque
+bool frontCovers = false;
+
 //Structs/Classes
 struct Circle
 {
@@ -99,6 +102,7 @@ class Window
 struct Circle;
 bool init();
 void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+bool covers_screen(SDL_Surface *surface);
 SDL_Surface *load_image(std::string filename);
 bool load_files();
 void clean_up();
@@ -156,9 +160,17 @@ int main(int argc, char* args[])
 
       SDL_SetAlpha(front, SDL_SRCALPHA, alpha);
 
-      apply_surface(0, 0, back, screen);
+      //At full alpha the front hides all of the back
+      if((alpha < SDL_ALPHA_OPAQUE) || (frontCovers == false))
+      {
+        apply_surface(0, 0, back, screen);
+      }
 
-      apply_surface(0, 0, front, screen);
+      //Fully transparent, the front adds nothing
+      if(alpha > SDL_ALPHA_TRANSPARENT)
+      {
+        apply_surface(0, 0, front, screen);
+      }
 
       if(SDL_Flip(screen) == -1)
       {
@@ -258,9 +270,47 @@ bool load_files()
     return false;
   }
 
+  frontCovers = covers_screen(front);
+
   return true;
 }
 
+bool covers_screen(SDL_Surface *surface)
+{
+  if((surface->w < SCREEN_WIDTH) || (surface->h < SCREEN_HEIGHT))
+  {
+    return false;
+  }
+
+  //A colour keyed pixel would let the back show through
+  if((surface->flags & SDL_SRCCOLORKEY) == 0)
+  {
+    return true;
+  }
+
+  bool covers = true;
+
+  SDL_LockSurface(surface);
+
+  for(int y = 0; (y < SCREEN_HEIGHT) && (covers == true); y++)
+  {
+    Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+
+    for(int x = 0; x < SCREEN_WIDTH; x++)
+    {
+      if(row[x] == surface->format->colorkey)
+      {
+        covers = false;
+        break;
+      }
+    }
+  }
+
+  SDL_UnlockSurface(surface);
+
+  return covers;
+}
+
 void clean_up()
 {
   SDL_FreeSurface(back);
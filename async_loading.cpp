@@ -0,0 +1,670 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include "SDL/SDL_ttf.h"
+#include "SDL/SDL_mixer.h"
+#include "SDL/SDL_thread.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+//The sounds lesson with its assets decoded on a pool of worker threads.
+//Workers do the file reads and decodes, the main thread only runs
+//SDL_DisplayFormat (video calls must stay on the main thread) and draws a
+//loading bar while it waits.
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int LOADER_THREADS = 4;
+
+//Structs/Classes
+enum AssetType
+{
+  ASSET_IMAGE,
+  ASSET_FONT,
+  ASSET_MUSIC,
+  ASSET_CHUNK
+};
+
+enum AssetState
+{
+  ASSET_QUEUED,
+  ASSET_DECODING,
+  ASSET_DECODED,
+  ASSET_READY,
+  ASSET_FAILED
+};
+
+struct Asset
+{
+  AssetType type;
+  std::string filename;
+  int fontSize;
+  AssetState state;
+
+  //Worker output; images still need converting on the main thread
+  SDL_Surface *decoded;
+
+  SDL_Surface *image;
+  TTF_Font *font;
+  Mix_Music *music;
+  Mix_Chunk *chunk;
+};
+
+typedef int AssetHandle;
+
+class AssetLoader
+{
+  private:
+    std::vector<Asset *> assets;
+    std::vector<SDL_Thread *> workers;
+
+    SDL_mutex *lock;
+    SDL_cond *decoded;
+
+    //SDL_ttf shares one FreeType library between all fonts
+    SDL_mutex *ttfLock;
+
+    unsigned int nextJob;
+    int ready;
+    bool failures;
+
+    static int worker(void *data);
+    void decode(Asset *asset);
+    AssetHandle queue(AssetType type, std::string filename, int fontSize);
+    int update();
+
+  public:
+    AssetLoader();
+    ~AssetLoader();
+    AssetHandle load_image(std::string filename);
+    AssetHandle load_font(std::string filename, int size);
+    AssetHandle load_music(std::string filename);
+    AssetHandle load_chunk(std::string filename);
+    bool start(int threads);
+    bool wait(void (*progress)(int ready, int total));
+    void stop();
+    SDL_Surface *get_image(AssetHandle handle);
+    TTF_Font *get_font(AssetHandle handle);
+    Mix_Music *get_music(AssetHandle handle);
+    Mix_Chunk *get_chunk(AssetHandle handle);
+};
+
+//Globals
+SDL_Surface *background = NULL;
+SDL_Surface *screen = NULL;
+SDL_Surface *message = NULL;
+
+SDL_Event event;
+TTF_Font *font = NULL;
+SDL_Color textColor = {0, 0, 0};
+
+Mix_Music *music = NULL;
+
+Mix_Chunk *scratch = NULL;
+Mix_Chunk *high= NULL;
+Mix_Chunk *med= NULL;
+Mix_Chunk *low= NULL;
+
+bool quit = false;
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *optimize_image(SDL_Surface *loadedImage);
+bool load_files();
+void show_progress(int ready, int total);
+void clean_up();
+
+//Functions
+int main(int argc, char* args[])
+{
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  Uint32 loadStart = SDL_GetTicks();
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  std::stringstream caption;
+  caption << "SOUNDS!! - loaded in " << SDL_GetTicks() - loadStart << " ms";
+  SDL_WM_SetCaption(caption.str().c_str(), NULL);
+
+  apply_surface(0, 0, background, screen);
+  message = TTF_RenderText_Solid(font, "1, 2, 3, or 4 to play a sound effect", textColor);
+
+  if(message == NULL)
+  {
+    return 1;
+  }
+
+  apply_surface((SCREEN_WIDTH - message->w) / 2, 100, message, screen);
+  SDL_FreeSurface(message);
+
+  message = TTF_RenderText_Solid(font, "Press 9 to play or pause the music", textColor);
+
+  if(message == NULL)
+  {
+    return 1;
+  }
+
+  apply_surface((SCREEN_WIDTH - message->w) / 2, 200, message, screen);
+  SDL_FreeSurface(message);
+
+  message = TTF_RenderText_Solid(font, "Press 0 to stop the music", textColor);
+
+  if(message == NULL)
+  {
+    return 1;
+  }
+
+  apply_surface((SCREEN_WIDTH - message->w) / 2, 300, message, screen);
+  SDL_FreeSurface(message);
+
+  if(SDL_Flip(screen) == -1)
+  {
+    return 1;
+  }
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    while(SDL_PollEvent(&event))
+    {
+      if(event.type == SDL_KEYDOWN)
+      {
+        if(event.key.keysym.sym == SDLK_1)
+        {
+          if(Mix_PlayChannel(-1, scratch, 0) == -1)
+          {
+            return 1;
+          }
+        }
+        else if(event.key.keysym.sym == SDLK_2)
+        {
+          if(Mix_PlayChannel(-1, high, 0) == -1)
+          {
+            return 1;
+          }
+        }
+        else if(event.key.keysym.sym == SDLK_3)
+        {
+          if(Mix_PlayChannel(-1, med, 0) == -1)
+          {
+            return 1;
+          }
+        }
+        else if(event.key.keysym.sym == SDLK_4)
+        {
+          if(Mix_PlayChannel(-1, low, 0) == -1)
+          {
+            return 1;
+          }
+        }
+        else if(event.key.keysym.sym == SDLK_9)
+        {
+          if(Mix_PlayingMusic() == 0)
+          {
+            if(Mix_PlayMusic(music, -1) == -1)
+            {
+              return 1;
+            }
+          }
+          else
+          {
+            if(Mix_PausedMusic() == 1)
+            {
+              Mix_ResumeMusic();
+            }
+            else
+            {
+              Mix_PauseMusic();
+            }
+          }
+        }
+        else if(event.key.keysym.sym == SDLK_0)
+        {
+          Mix_HaltMusic();
+        }
+      }
+
+      if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+  }
+
+  clean_up();
+  return 0;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *optimize_image(SDL_Surface *loadedImage)
+{
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  //Return the optimized image
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  //Set up screen
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  //If there was an error setting up the screen
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  if(TTF_Init() == -1)
+  {
+    return false;
+  }
+
+  if(Mix_OpenAudio(22050, MIX_DEFAULT_FORMAT, 2, 4096) == -1)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("SOUNDS!!", NULL);
+
+  return true;
+}
+
+bool load_files()
+{
+  AssetLoader loader;
+
+  //Queue everything up front, nothing blocks here
+  AssetHandle backgroundAsset = loader.load_image("background.png");
+  AssetHandle fontAsset = loader.load_font("lazy.ttf", 30);
+  AssetHandle musicAsset = loader.load_music("beat.wav");
+  AssetHandle scratchAsset = loader.load_chunk("scratch.wav");
+  AssetHandle highAsset = loader.load_chunk("high.wav");
+  AssetHandle medAsset = loader.load_chunk("medium.wav");
+  AssetHandle lowAsset = loader.load_chunk("low.wav");
+
+  if(loader.start(LOADER_THREADS) == false)
+  {
+    return false;
+  }
+
+  bool loaded = loader.wait(show_progress);
+
+  background = loader.get_image(backgroundAsset);
+  font = loader.get_font(fontAsset);
+  music = loader.get_music(musicAsset);
+  scratch = loader.get_chunk(scratchAsset);
+  high = loader.get_chunk(highAsset);
+  med = loader.get_chunk(medAsset);
+  low = loader.get_chunk(lowAsset);
+
+  if((loaded == false) || (quit == true))
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void show_progress(int ready, int total)
+{
+  //Keep the window responsive while the workers run
+  while(SDL_PollEvent(&event))
+  {
+    if(event.type == SDL_QUIT)
+    {
+      quit = true;
+    }
+  }
+
+  SDL_Rect bar;
+  bar.x = SCREEN_WIDTH / 4;
+  bar.y = (SCREEN_HEIGHT - 20) / 2;
+  bar.w = SCREEN_WIDTH / 2;
+  bar.h = 20;
+
+  SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+  SDL_FillRect(screen, &bar, SDL_MapRGB(screen->format, 0xC0, 0xC0, 0xC0));
+
+  bar.w = (bar.w * ready) / total;
+  SDL_FillRect(screen, &bar, SDL_MapRGB(screen->format, 0, 0, 0));
+
+  SDL_Flip(screen);
+}
+
+void clean_up()
+{
+  //Free the images
+  SDL_FreeSurface(background);
+
+  Mix_FreeChunk(scratch);
+  Mix_FreeChunk(high);
+  Mix_FreeChunk(med);
+  Mix_FreeChunk(low);
+
+  Mix_FreeMusic(music);
+
+  Mix_CloseAudio();
+
+  TTF_CloseFont(font);
+
+  TTF_Quit();
+
+  //Quit SDL
+  SDL_Quit();
+}
+
+AssetLoader::AssetLoader()
+{
+  lock = SDL_CreateMutex();
+  decoded = SDL_CreateCond();
+  ttfLock = SDL_CreateMutex();
+  nextJob = 0;
+  ready = 0;
+  failures = false;
+}
+
+AssetLoader::~AssetLoader()
+{
+  stop();
+
+  for(unsigned int a = 0; a < assets.size(); a++)
+  {
+    delete assets[a];
+  }
+
+  SDL_DestroyMutex(ttfLock);
+  SDL_DestroyCond(decoded);
+  SDL_DestroyMutex(lock);
+}
+
+AssetHandle AssetLoader::queue(AssetType type, std::string filename, int fontSize)
+{
+  Asset *asset = new Asset;
+  asset->type = type;
+  asset->filename = filename;
+  asset->fontSize = fontSize;
+  asset->state = ASSET_QUEUED;
+  asset->decoded = NULL;
+  asset->image = NULL;
+  asset->font = NULL;
+  asset->music = NULL;
+  asset->chunk = NULL;
+
+  assets.push_back(asset);
+  return assets.size() - 1;
+}
+
+AssetHandle AssetLoader::load_image(std::string filename)
+{
+  return queue(ASSET_IMAGE, filename, 0);
+}
+
+AssetHandle AssetLoader::load_font(std::string filename, int size)
+{
+  return queue(ASSET_FONT, filename, size);
+}
+
+AssetHandle AssetLoader::load_music(std::string filename)
+{
+  return queue(ASSET_MUSIC, filename, 0);
+}
+
+AssetHandle AssetLoader::load_chunk(std::string filename)
+{
+  return queue(ASSET_CHUNK, filename, 0);
+}
+
+bool AssetLoader::start(int threads)
+{
+  //All jobs must be queued before this
+  for(int t = 0; (t < threads) && (t < (int)assets.size()); t++)
+  {
+    SDL_Thread *thread = SDL_CreateThread(worker, this);
+
+    if(thread == NULL)
+    {
+      return false;
+    }
+
+    workers.push_back(thread);
+  }
+
+  return true;
+}
+
+int AssetLoader::worker(void *data)
+{
+  AssetLoader *loader = (AssetLoader *)data;
+
+  while(true)
+  {
+    Asset *asset = NULL;
+
+    SDL_mutexP(loader->lock);
+
+    if(loader->nextJob < loader->assets.size())
+    {
+      asset = loader->assets[loader->nextJob];
+      asset->state = ASSET_DECODING;
+      loader->nextJob++;
+    }
+
+    SDL_mutexV(loader->lock);
+
+    //Nothing left to take
+    if(asset == NULL)
+    {
+      return 0;
+    }
+
+    loader->decode(asset);
+
+    SDL_mutexP(loader->lock);
+    SDL_CondSignal(loader->decoded);
+    SDL_mutexV(loader->lock);
+  }
+}
+
+void AssetLoader::decode(Asset *asset)
+{
+  bool loaded = false;
+
+  switch(asset->type)
+  {
+    case ASSET_IMAGE:
+      asset->decoded = IMG_Load(asset->filename.c_str());
+      loaded = (asset->decoded != NULL);
+      break;
+
+    case ASSET_FONT:
+      SDL_mutexP(ttfLock);
+      asset->font = TTF_OpenFont(asset->filename.c_str(), asset->fontSize);
+      SDL_mutexV(ttfLock);
+      loaded = (asset->font != NULL);
+      break;
+
+    case ASSET_MUSIC:
+      asset->music = Mix_LoadMUS(asset->filename.c_str());
+      loaded = (asset->music != NULL);
+      break;
+
+    case ASSET_CHUNK:
+      asset->chunk = Mix_LoadWAV(asset->filename.c_str());
+      loaded = (asset->chunk != NULL);
+      break;
+  }
+
+  SDL_mutexP(lock);
+  asset->state = (loaded == true) ? ASSET_DECODED : ASSET_FAILED;
+  SDL_mutexV(lock);
+}
+
+int AssetLoader::update()
+{
+  //Main thread only: finish whatever the workers handed back
+  std::vector<Asset *> finished;
+
+  SDL_mutexP(lock);
+
+  for(unsigned int a = 0; a < assets.size(); a++)
+  {
+    if(assets[a]->state == ASSET_DECODED)
+    {
+      finished.push_back(assets[a]);
+    }
+    else if(assets[a]->state == ASSET_FAILED)
+    {
+      failures = true;
+    }
+  }
+
+  SDL_mutexV(lock);
+
+  for(unsigned int f = 0; f < finished.size(); f++)
+  {
+    if(finished[f]->type == ASSET_IMAGE)
+    {
+      finished[f]->image = optimize_image(finished[f]->decoded);
+      finished[f]->decoded = NULL;
+
+      if(finished[f]->image == NULL)
+      {
+        failures = true;
+      }
+    }
+  }
+
+  SDL_mutexP(lock);
+
+  for(unsigned int f = 0; f < finished.size(); f++)
+  {
+    finished[f]->state = ASSET_READY;
+  }
+
+  ready += finished.size();
+
+  SDL_mutexV(lock);
+
+  return finished.size();
+}
+
+bool AssetLoader::wait(void (*progress)(int ready, int total))
+{
+  int total = assets.size();
+  int settled = 0;
+
+  progress(0, total);
+
+  while(settled < total)
+  {
+    SDL_mutexP(lock);
+
+    //Wake up on every finished job, or now and then to keep drawing
+    SDL_CondWaitTimeout(decoded, lock, 15);
+    SDL_mutexV(lock);
+
+    update();
+
+    settled = 0;
+
+    SDL_mutexP(lock);
+
+    for(int a = 0; a < total; a++)
+    {
+      if((assets[a]->state == ASSET_READY) || (assets[a]->state == ASSET_FAILED))
+      {
+        settled++;
+      }
+    }
+
+    SDL_mutexV(lock);
+
+    progress(ready, total);
+  }
+
+  stop();
+
+  return failures == false;
+}
+
+void AssetLoader::stop()
+{
+  //Workers exit on their own once the queue is empty
+  for(unsigned int t = 0; t < workers.size(); t++)
+  {
+    SDL_WaitThread(workers[t], NULL);
+  }
+
+  workers.clear();
+}
+
+SDL_Surface *AssetLoader::get_image(AssetHandle handle)
+{
+  return assets[handle]->image;
+}
+
+TTF_Font *AssetLoader::get_font(AssetHandle handle)
+{
+  return assets[handle]->font;
+}
+
+Mix_Music *AssetLoader::get_music(AssetHandle handle)
+{
+  return assets[handle]->music;
+}
+
+Mix_Chunk *AssetLoader::get_chunk(AssetHandle handle)
+{
+  return assets[handle]->chunk;
+}
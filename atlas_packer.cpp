@@ -0,0 +1,453 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+//Offline tool: packs loose sprite images into one or a few atlas pages and
+//writes a clip index the games look sprites up in by name.
+//Usage: atlas_packer <atlas name> <image> [<image> ...]
+
+//Constants
+const int ATLAS_WIDTH = 1024;
+const int ATLAS_HEIGHT = 1024;
+const int ATLAS_BPP = 32;
+const int ATLAS_VERSION = 1;
+
+//Structs/Classes
+struct Sprite
+{
+  std::string name;
+  std::string filename;
+  SDL_Surface *image;
+  int page;
+  SDL_Rect box;
+};
+
+struct SkylineNode
+{
+  int x, y;
+  int w;
+};
+
+//Skyline bottom-left packer for a single atlas page
+class Skyline
+{
+  private:
+    int width, height;
+    std::vector<SkylineNode> nodes;
+
+    int fit(int index, int w, int h);
+    void add_node(int index, int x, int y, int w, int h);
+
+  public:
+    Skyline(int W, int H);
+    bool insert(int w, int h, SDL_Rect *box);
+};
+
+//Globals
+Uint32 rmask = 0x00FF0000;
+Uint32 gmask = 0x0000FF00;
+Uint32 bmask = 0x000000FF;
+
+//Prototypes
+bool load_sprites(std::vector<Sprite> &sprites);
+bool pack_sprites(std::vector<Sprite> &sprites, int &pages);
+bool save_pages(std::string atlasName, std::vector<Sprite> &sprites, int pages);
+bool save_index(std::string atlasName, std::vector<Sprite> &sprites, int pages);
+std::string page_filename(std::string atlasName, int page);
+std::string sprite_name(std::string filename);
+bool taller(const Sprite &A, const Sprite &B);
+bool by_name(const Sprite &A, const Sprite &B);
+void clean_up(std::vector<Sprite> &sprites);
+
+//Functions
+int main(int argc, char* args[])
+{
+  std::vector<Sprite> sprites;
+  int pages = 0;
+
+  if(argc < 3)
+  {
+    std::cerr << "Usage: " << args[0] << " <atlas name> <image> [<image> ...]" << std::endl;
+    return 1;
+  }
+
+  //Only image loading is needed, no window
+  if(SDL_Init(0) == -1)
+  {
+    return 1;
+  }
+
+  for(int a = 2; a < argc; a++)
+  {
+    Sprite sprite;
+    sprite.filename = args[a];
+    sprite.name = sprite_name(args[a]);
+    sprite.image = NULL;
+    sprite.page = -1;
+    sprites.push_back(sprite);
+  }
+
+  if(load_sprites(sprites) == false)
+  {
+    clean_up(sprites);
+    return 1;
+  }
+
+  if(pack_sprites(sprites, pages) == false)
+  {
+    clean_up(sprites);
+    return 1;
+  }
+
+  if((save_pages(args[1], sprites, pages) == false) || (save_index(args[1], sprites, pages) == false))
+  {
+    clean_up(sprites);
+    return 1;
+  }
+
+  std::cout << "Packed " << sprites.size() << " sprites into " << pages << " page(s)" << std::endl;
+
+  clean_up(sprites);
+  return 0;
+}
+
+bool load_sprites(std::vector<Sprite> &sprites)
+{
+  for(unsigned int s = 0; s < sprites.size(); s++)
+  {
+    SDL_Surface *loadedImage = IMG_Load(sprites[s].filename.c_str());
+
+    if(loadedImage == NULL)
+    {
+      std::cerr << "Could not load " << sprites[s].filename << ": " << SDL_GetError() << std::endl;
+      return false;
+    }
+
+    //Copy into a plain 32 bit surface so every page has the same format
+    sprites[s].image = SDL_CreateRGBSurface(SDL_SWSURFACE, loadedImage->w, loadedImage->h, ATLAS_BPP, rmask, gmask, bmask, 0);
+
+    if(sprites[s].image == NULL)
+    {
+      SDL_FreeSurface(loadedImage);
+      return false;
+    }
+
+    //Raw copy, the same way SDL_DisplayFormat drops the alpha channel
+    SDL_SetAlpha(loadedImage, 0, SDL_ALPHA_OPAQUE);
+    SDL_BlitSurface(loadedImage, NULL, sprites[s].image, NULL);
+    SDL_FreeSurface(loadedImage);
+
+    if((sprites[s].image->w > ATLAS_WIDTH) || (sprites[s].image->h > ATLAS_HEIGHT))
+    {
+      std::cerr << sprites[s].filename << " is bigger than an atlas page" << std::endl;
+      return false;
+    }
+
+    for(unsigned int d = 0; d < s; d++)
+    {
+      if(sprites[d].name == sprites[s].name)
+      {
+        std::cerr << "Duplicate sprite name " << sprites[s].name << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool pack_sprites(std::vector<Sprite> &sprites, int &pages)
+{
+  std::vector<Skyline> skylines;
+
+  //Tallest first keeps the skyline flat
+  std::stable_sort(sprites.begin(), sprites.end(), taller);
+
+  for(unsigned int s = 0; s < sprites.size(); s++)
+  {
+    int w = sprites[s].image->w;
+    int h = sprites[s].image->h;
+
+    //Try the pages we already have before opening a new one
+    for(unsigned int p = 0; p < skylines.size(); p++)
+    {
+      if(skylines[p].insert(w, h, &sprites[s].box) == true)
+      {
+        sprites[s].page = p;
+        break;
+      }
+    }
+
+    if(sprites[s].page == -1)
+    {
+      skylines.push_back(Skyline(ATLAS_WIDTH, ATLAS_HEIGHT));
+
+      if(skylines.back().insert(w, h, &sprites[s].box) == false)
+      {
+        return false;
+      }
+
+      sprites[s].page = skylines.size() - 1;
+    }
+  }
+
+  pages = skylines.size();
+  return true;
+}
+
+bool save_pages(std::string atlasName, std::vector<Sprite> &sprites, int pages)
+{
+  for(int p = 0; p < pages; p++)
+  {
+    //Shrink the page to the area actually used
+    int pageW = 0, pageH = 0;
+
+    for(unsigned int s = 0; s < sprites.size(); s++)
+    {
+      if(sprites[s].page == p)
+      {
+        pageW = std::max(pageW, sprites[s].box.x + sprites[s].box.w);
+        pageH = std::max(pageH, sprites[s].box.y + sprites[s].box.h);
+      }
+    }
+
+    SDL_Surface *page = SDL_CreateRGBSurface(SDL_SWSURFACE, pageW, pageH, ATLAS_BPP, rmask, gmask, bmask, 0);
+
+    if(page == NULL)
+    {
+      return false;
+    }
+
+    //Unused space gets the color key so it never shows up
+    SDL_FillRect(page, &page->clip_rect, SDL_MapRGB(page->format, 0, 0xFF, 0xFF));
+
+    for(unsigned int s = 0; s < sprites.size(); s++)
+    {
+      if(sprites[s].page == p)
+      {
+        SDL_Rect offset = sprites[s].box;
+        SDL_BlitSurface(sprites[s].image, NULL, page, &offset);
+      }
+    }
+
+    std::string filename = page_filename(atlasName, p);
+
+    if(SDL_SaveBMP(page, filename.c_str()) == -1)
+    {
+      std::cerr << "Could not save " << filename << ": " << SDL_GetError() << std::endl;
+      SDL_FreeSurface(page);
+      return false;
+    }
+
+    SDL_FreeSurface(page);
+  }
+
+  return true;
+}
+
+bool save_index(std::string atlasName, std::vector<Sprite> &sprites, int pages)
+{
+  std::ofstream index((atlasName + ".atlas").c_str());
+
+  if(index == NULL)
+  {
+    return false;
+  }
+
+  //The runtime does a binary search, so write the sprites sorted by name
+  std::vector<Sprite> sorted = sprites;
+  std::sort(sorted.begin(), sorted.end(), by_name);
+
+  index << "ATLAS " << ATLAS_VERSION << " " << pages << " " << sorted.size() << "\n";
+
+  for(int p = 0; p < pages; p++)
+  {
+    index << page_filename(atlasName, p) << "\n";
+  }
+
+  for(unsigned int s = 0; s < sorted.size(); s++)
+  {
+    index << sorted[s].name << " " << sorted[s].page << " ";
+    index << sorted[s].box.x << " " << sorted[s].box.y << " ";
+    index << sorted[s].box.w << " " << sorted[s].box.h << "\n";
+  }
+
+  index.close();
+  return true;
+}
+
+std::string page_filename(std::string atlasName, int page)
+{
+  std::stringstream filename;
+  filename << atlasName << page << ".bmp";
+  return filename.str();
+}
+
+std::string sprite_name(std::string filename)
+{
+  //"images/dot.png" becomes "dot"
+  std::string::size_type slash = filename.find_last_of("/\\");
+
+  if(slash != std::string::npos)
+  {
+    filename = filename.substr(slash + 1);
+  }
+
+  std::string::size_type dot = filename.find_last_of('.');
+
+  if(dot != std::string::npos)
+  {
+    filename = filename.substr(0, dot);
+  }
+
+  return filename;
+}
+
+bool taller(const Sprite &A, const Sprite &B)
+{
+  if(A.image->h != B.image->h)
+  {
+    return A.image->h > B.image->h;
+  }
+
+  return A.image->w > B.image->w;
+}
+
+bool by_name(const Sprite &A, const Sprite &B)
+{
+  return A.name < B.name;
+}
+
+void clean_up(std::vector<Sprite> &sprites)
+{
+  for(unsigned int s = 0; s < sprites.size(); s++)
+  {
+    SDL_FreeSurface(sprites[s].image);
+  }
+
+  SDL_Quit();
+}
+
+Skyline::Skyline(int W, int H)
+{
+  width = W;
+  height = H;
+
+  SkylineNode first;
+  first.x = 0;
+  first.y = 0;
+  first.w = W;
+  nodes.push_back(first);
+}
+
+int Skyline::fit(int index, int w, int h)
+{
+  //Returns the y the rect would rest at starting on this node, or -1
+  int x = nodes[index].x;
+  int y = nodes[index].y;
+  int widthLeft = w;
+
+  if(x + w > width)
+  {
+    return -1;
+  }
+
+  while(widthLeft > 0)
+  {
+    y = std::max(y, nodes[index].y);
+
+    if(y + h > height)
+    {
+      return -1;
+    }
+
+    widthLeft -= nodes[index].w;
+    index++;
+  }
+
+  return y;
+}
+
+bool Skyline::insert(int w, int h, SDL_Rect *box)
+{
+  int bestIndex = -1;
+  int bestY = height;
+  int bestWidth = width;
+
+  for(unsigned int n = 0; n < nodes.size(); n++)
+  {
+    int y = fit(n, w, h);
+
+    if(y != -1)
+    {
+      //Lowest top edge wins, narrowest node breaks ties
+      if((y + h < bestY) || ((y + h == bestY) && (nodes[n].w < bestWidth)))
+      {
+        bestIndex = n;
+        bestY = y + h;
+        bestWidth = nodes[n].w;
+      }
+    }
+  }
+
+  if(bestIndex == -1)
+  {
+    return false;
+  }
+
+  box->x = nodes[bestIndex].x;
+  box->y = bestY - h;
+  box->w = w;
+  box->h = h;
+
+  add_node(bestIndex, box->x, box->y, w, h);
+  return true;
+}
+
+void Skyline::add_node(int index, int x, int y, int w, int h)
+{
+  SkylineNode node;
+  node.x = x;
+  node.y = y + h;
+  node.w = w;
+  nodes.insert(nodes.begin() + index, node);
+
+  //Trim or remove the nodes the new one now covers
+  for(unsigned int n = index + 1; n < nodes.size(); n++)
+  {
+    int previousRight = nodes[n - 1].x + nodes[n - 1].w;
+
+    if(nodes[n].x >= previousRight)
+    {
+      break;
+    }
+
+    int shrink = previousRight - nodes[n].x;
+    nodes[n].x += shrink;
+    nodes[n].w -= shrink;
+
+    if(nodes[n].w > 0)
+    {
+      break;
+    }
+
+    nodes.erase(nodes.begin() + n);
+    n--;
+  }
+
+  //Merge neighbours at the same height
+  for(unsigned int n = 0; n + 1 < nodes.size(); n++)
+  {
+    if(nodes[n].y == nodes[n + 1].y)
+    {
+      nodes[n].w += nodes[n + 1].w;
+      nodes.erase(nodes.begin() + n + 1);
+      n--;
+    }
+  }
+}
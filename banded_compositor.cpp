@@ -0,0 +1,789 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include "SDL/SDL_thread.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+
+//Software compositor that splits the screen into horizontal bands and lets a
+//pool of threads blit every draw that touches a band, in draw order.
+//Every pixel is still written by the same sequence of blits as a plain
+//SDL_BlitSurface pass in draw order, so the output is identical.
+//Usage: banded_compositor [threads] [width] [height]
+//  S toggles serial/banded rendering, V checks every frame against serial
+
+//Constants
+//Screen size can be overridden from the command line
+int SCREEN_WIDTH = 640;
+int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+const int TOTAL_DOTS = 2000;
+const int BANDS_PER_THREAD = 4;
+
+//Structs/Classes
+struct DrawCommand
+{
+  //NULL source means filling x, y, w, h with color
+  SDL_Surface *source;
+  SDL_Rect clip;
+  int x, y, w, h;
+  Uint32 color;
+};
+
+class DrawList
+{
+  private:
+    std::vector<DrawCommand> commands;
+
+  public:
+    void clear();
+    void blit(int x, int y, SDL_Surface *source, SDL_Rect *clip = NULL);
+    void fill(SDL_Rect *box, Uint32 color);
+    int size();
+    DrawCommand &get(int command);
+};
+
+class Compositor
+{
+  private:
+    std::vector<SDL_Thread *> workers;
+    SDL_mutex *lock;
+    SDL_cond *frameReady;
+    SDL_cond *frameDone;
+
+    //The frame being rendered
+    DrawList *list;
+    SDL_Surface *target;
+    int frame;
+    int bandHeight;
+    int bandCount;
+    int nextBand;
+    int bandsDone;
+    bool quitting;
+
+    static int worker(void *data);
+    void render_bands();
+    void render_band(int band);
+    void bind_sources();
+
+  public:
+    Compositor();
+    ~Compositor();
+    bool start(int threads);
+    void render(DrawList &drawList, SDL_Surface *surface);
+    void render_serial(DrawList &drawList, SDL_Surface *surface);
+    void stop();
+};
+
+class Dot
+{
+  private:
+    int x, y;
+    int xVel, yVel;
+    SDL_Surface *sprite;
+
+  public:
+    Dot();
+    void move();
+    void show(DrawList &drawList);
+};
+
+class Timer
+{
+  private:
+    int startTicks;
+    int pausedTicks;
+
+    bool paused;
+    bool started;
+
+  public:
+    Timer();
+    void start();
+    void stop();
+    void pause();
+    void unpause();
+    int get_ticks();
+    bool is_started();
+    bool is_paused();
+};
+
+//Globals
+SDL_Surface *background = NULL;
+SDL_Surface *dot = NULL;
+SDL_Surface *red = NULL;
+SDL_Surface *screen = NULL;
+SDL_Surface *reference = NULL;
+SDL_Event event;
+
+//Prototypes
+bool init();
+SDL_Surface *load_image(std::string filename);
+bool load_files();
+void clean_up();
+bool intersect(int x, int y, int w, int h, int clipX, int clipY, int clipW, int clipH, SDL_Rect *result);
+
+//Functions
+int main(int argc, char* args[])
+{
+  bool quit = false;
+  bool serial = false;
+  bool verify = false;
+  int threads = sysconf(_SC_NPROCESSORS_ONLN);
+  int frame = 0, frameTicks = 0, mismatches = 0;
+
+  if(argc > 1)
+  {
+    threads = atoi(args[1]);
+  }
+
+  if(argc > 3)
+  {
+    SCREEN_WIDTH = atoi(args[2]);
+    SCREEN_HEIGHT = atoi(args[3]);
+  }
+
+  if(threads < 1)
+  {
+    threads = 1;
+  }
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  Compositor compositor;
+  DrawList drawList;
+  std::vector<Dot> dots(TOTAL_DOTS);
+  Timer update;
+
+  //The calling thread renders bands too
+  if(compositor.start(threads - 1) == false)
+  {
+    return 1;
+  }
+
+  update.start();
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    while(SDL_PollEvent(&event))
+    {
+      if(event.type == SDL_KEYDOWN)
+      {
+        if(event.key.keysym.sym == SDLK_s)
+        {
+          serial = !serial;
+        }
+        else if(event.key.keysym.sym == SDLK_v)
+        {
+          verify = !verify;
+        }
+      }
+
+      if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    for(int d = 0; d < TOTAL_DOTS; d++)
+    {
+      dots[d].move();
+    }
+
+    //Build the frame
+    drawList.clear();
+    drawList.fill(&screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+
+    for(int y = 0; y < SCREEN_HEIGHT; y += background->h)
+    {
+      for(int x = 0; x < SCREEN_WIDTH; x += background->w)
+      {
+        drawList.blit(x, y, background);
+      }
+    }
+
+    for(int d = 0; d < TOTAL_DOTS; d++)
+    {
+      dots[d].show(drawList);
+    }
+
+    Uint32 renderStart = SDL_GetTicks();
+
+    if(serial == true)
+    {
+      compositor.render_serial(drawList, screen);
+    }
+    else
+    {
+      compositor.render(drawList, screen);
+    }
+
+    frameTicks += SDL_GetTicks() - renderStart;
+
+    if(verify == true)
+    {
+      compositor.render_serial(drawList, reference);
+
+      for(int row = 0; row < SCREEN_HEIGHT; row++)
+      {
+        Uint8 *a = (Uint8 *)screen->pixels + row * screen->pitch;
+        Uint8 *b = (Uint8 *)reference->pixels + row * reference->pitch;
+
+        if(memcmp(a, b, SCREEN_WIDTH * screen->format->BytesPerPixel) != 0)
+        {
+          mismatches++;
+          break;
+        }
+      }
+    }
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    frame++;
+
+    if(update.get_ticks() > 1000)
+    {
+      std::stringstream caption;
+      caption << (serial ? "Serial" : "Banded") << " " << SCREEN_WIDTH << "x" << SCREEN_HEIGHT;
+      caption << " - render " << (float)frameTicks / frame << " ms/frame";
+
+      if(verify == true)
+      {
+        caption << " - mismatched frames: " << mismatches;
+      }
+
+      SDL_WM_SetCaption(caption.str().c_str(), NULL);
+
+      frame = 0;
+      frameTicks = 0;
+      update.start();
+    }
+  }
+
+  compositor.stop();
+
+  clean_up();
+  return 0;
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  //Bands are blitted without locking, so the screen has to be a software surface
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if((screen == NULL) || (SDL_MUSTLOCK(screen)))
+  {
+    return false;
+  }
+
+  //Serial render target for checking the banded output
+  reference = SDL_CreateRGBSurface(SDL_SWSURFACE, SCREEN_WIDTH, SCREEN_HEIGHT, screen->format->BitsPerPixel,
+                                   screen->format->Rmask, screen->format->Gmask, screen->format->Bmask, screen->format->Amask);
+
+  if(reference == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Banded Compositor", NULL);
+
+  srand(SDL_GetTicks());
+
+  return true;
+}
+
+bool load_files()
+{
+  background = load_image("background.png");
+  dot = load_image("dot.bmp");
+  red = load_image("red.bmp");
+
+  if((background == NULL) || (dot == NULL) || (red == NULL))
+  {
+    return false;
+  }
+
+  SDL_SetAlpha(red, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+
+  return true;
+}
+
+void clean_up()
+{
+  SDL_FreeSurface(background);
+  SDL_FreeSurface(dot);
+  SDL_FreeSurface(red);
+  SDL_FreeSurface(reference);
+
+  SDL_Quit();
+}
+
+bool intersect(int x, int y, int w, int h, int clipX, int clipY, int clipW, int clipH, SDL_Rect *result)
+{
+  int left = std::max(x, clipX);
+  int top = std::max(y, clipY);
+  int right = std::min(x + w, clipX + clipW);
+  int bottom = std::min(y + h, clipY + clipH);
+
+  if((right <= left) || (bottom <= top))
+  {
+    return false;
+  }
+
+  result->x = left;
+  result->y = top;
+  result->w = right - left;
+  result->h = bottom - top;
+
+  return true;
+}
+
+void DrawList::clear()
+{
+  commands.clear();
+}
+
+void DrawList::blit(int x, int y, SDL_Surface *source, SDL_Rect *clip)
+{
+  DrawCommand command;
+  command.source = source;
+  command.color = 0;
+
+  //Keep the clip inside the source, like SDL_BlitSurface does
+  if(clip == NULL)
+  {
+    command.clip = source->clip_rect;
+  }
+  else if(intersect(clip->x, clip->y, clip->w, clip->h, 0, 0, source->w, source->h, &command.clip) == false)
+  {
+    return;
+  }
+
+  command.x = x + (command.clip.x - (clip == NULL ? 0 : clip->x));
+  command.y = y + (command.clip.y - (clip == NULL ? 0 : clip->y));
+  command.w = command.clip.w;
+  command.h = command.clip.h;
+
+  commands.push_back(command);
+}
+
+void DrawList::fill(SDL_Rect *box, Uint32 color)
+{
+  DrawCommand command;
+  command.source = NULL;
+  command.x = box->x;
+  command.y = box->y;
+  command.w = box->w;
+  command.h = box->h;
+  command.color = color;
+
+  commands.push_back(command);
+}
+
+int DrawList::size()
+{
+  return commands.size();
+}
+
+DrawCommand &DrawList::get(int command)
+{
+  return commands[command];
+}
+
+Compositor::Compositor()
+{
+  lock = SDL_CreateMutex();
+  frameReady = SDL_CreateCond();
+  frameDone = SDL_CreateCond();
+  list = NULL;
+  target = NULL;
+  frame = 0;
+  bandHeight = 0;
+  bandCount = 0;
+  nextBand = 0;
+  bandsDone = 0;
+  quitting = false;
+}
+
+Compositor::~Compositor()
+{
+  stop();
+
+  SDL_DestroyCond(frameDone);
+  SDL_DestroyCond(frameReady);
+  SDL_DestroyMutex(lock);
+}
+
+bool Compositor::start(int threads)
+{
+  for(int t = 0; t < threads; t++)
+  {
+    SDL_Thread *thread = SDL_CreateThread(worker, this);
+
+    if(thread == NULL)
+    {
+      return false;
+    }
+
+    workers.push_back(thread);
+  }
+
+  return true;
+}
+
+void Compositor::stop()
+{
+  SDL_mutexP(lock);
+  quitting = true;
+  SDL_CondBroadcast(frameReady);
+  SDL_mutexV(lock);
+
+  for(unsigned int t = 0; t < workers.size(); t++)
+  {
+    SDL_WaitThread(workers[t], NULL);
+  }
+
+  workers.clear();
+}
+
+int Compositor::worker(void *data)
+{
+  Compositor *compositor = (Compositor *)data;
+  int seenFrame = 0;
+
+  SDL_mutexP(compositor->lock);
+
+  while(true)
+  {
+    while((compositor->frame == seenFrame) && (compositor->quitting == false))
+    {
+      SDL_CondWait(compositor->frameReady, compositor->lock);
+    }
+
+    if(compositor->quitting == true)
+    {
+      SDL_mutexV(compositor->lock);
+      return 0;
+    }
+
+    seenFrame = compositor->frame;
+
+    SDL_mutexV(compositor->lock);
+    compositor->render_bands();
+    SDL_mutexP(compositor->lock);
+  }
+}
+
+void Compositor::render(DrawList &drawList, SDL_Surface *surface)
+{
+  //Workers write fills as 32 bit pixels and can't lock the target
+  if((surface->format->BytesPerPixel != 4) || (SDL_MUSTLOCK(surface)))
+  {
+    render_serial(drawList, surface);
+    return;
+  }
+
+  //Only the blit maps are shared between threads, build them up front
+  list = &drawList;
+  target = surface;
+  bind_sources();
+
+  //A few bands per thread evens out bands that hold more sprites
+  int threads = workers.size() + 1;
+  bandHeight = (target->h + threads * BANDS_PER_THREAD - 1) / (threads * BANDS_PER_THREAD);
+
+  if(bandHeight < 1)
+  {
+    bandHeight = 1;
+  }
+
+  SDL_mutexP(lock);
+  bandCount = (target->h + bandHeight - 1) / bandHeight;
+  nextBand = 0;
+  bandsDone = 0;
+  frame++;
+  SDL_CondBroadcast(frameReady);
+  SDL_mutexV(lock);
+
+  render_bands();
+
+  SDL_mutexP(lock);
+
+  while(bandsDone < bandCount)
+  {
+    SDL_CondWait(frameDone, lock);
+  }
+
+  SDL_mutexV(lock);
+}
+
+void Compositor::render_serial(DrawList &drawList, SDL_Surface *surface)
+{
+  for(int c = 0; c < drawList.size(); c++)
+  {
+    DrawCommand &command = drawList.get(c);
+    SDL_Rect offset;
+    offset.x = command.x;
+    offset.y = command.y;
+    offset.w = command.w;
+    offset.h = command.h;
+
+    if(command.source == NULL)
+    {
+      SDL_FillRect(surface, &offset, command.color);
+    }
+    else
+    {
+      SDL_BlitSurface(command.source, &command.clip, surface, &offset);
+    }
+  }
+}
+
+void Compositor::render_bands()
+{
+  SDL_mutexP(lock);
+
+  while(nextBand < bandCount)
+  {
+    int band = nextBand;
+    nextBand++;
+
+    SDL_mutexV(lock);
+    render_band(band);
+    SDL_mutexP(lock);
+
+    bandsDone++;
+
+    if(bandsDone == bandCount)
+    {
+      SDL_CondSignal(frameDone);
+    }
+  }
+
+  SDL_mutexV(lock);
+}
+
+void Compositor::render_band(int band)
+{
+  int top = band * bandHeight;
+  int height = std::min(bandHeight, target->h - top);
+
+  for(int c = 0; c < list->size(); c++)
+  {
+    DrawCommand &command = list->get(c);
+    SDL_Rect area;
+
+    //Part of this draw that lands in the band
+    if(intersect(command.x, command.y, command.w, command.h, 0, top, target->w, height, &area) == false)
+    {
+      continue;
+    }
+
+    if(command.source == NULL)
+    {
+      //SDL_FillRect() locks the target, and the lock count isn't thread safe
+      for(int y = area.y; y < area.y + area.h; y++)
+      {
+        Uint32 *row = (Uint32 *)((Uint8 *)target->pixels + y * target->pitch) + area.x;
+
+        for(int x = 0; x < area.w; x++)
+        {
+          row[x] = command.color;
+        }
+      }
+    }
+    else
+    {
+      SDL_Rect source;
+      source.x = command.clip.x + (area.x - command.x);
+      source.y = command.clip.y + (area.y - command.y);
+      source.w = area.w;
+      source.h = area.h;
+
+      //Rects are already clipped, skip SDL_UpperBlit's clipping
+      SDL_LowerBlit(command.source, &source, target, &area);
+    }
+  }
+}
+
+void Compositor::bind_sources()
+{
+  //SDL builds a surface's blit map (and RLE data) lazily on the first blit
+  //to a new destination. An empty blit does that here so the workers only
+  //ever read it.
+  SDL_Surface *last = NULL;
+
+  for(int c = 0; c < list->size(); c++)
+  {
+    SDL_Surface *source = list->get(c).source;
+
+    if((source != NULL) && (source != last))
+    {
+      SDL_Rect empty = {0, 0, 0, 0};
+      SDL_Rect offset = {0, 0, 0, 0};
+      SDL_LowerBlit(source, &empty, target, &offset);
+      last = source;
+    }
+  }
+}
+
+Dot::Dot()
+{
+  x = rand() % (SCREEN_WIDTH - DOT_WIDTH);
+  y = rand() % (SCREEN_HEIGHT - DOT_HEIGHT);
+  xVel = (rand() % 9) - 4;
+  yVel = (rand() % 9) - 4;
+
+  //Mix colour keyed and alpha blended sprites
+  sprite = (rand() % 2 == 0) ? dot : red;
+}
+
+void Dot::move()
+{
+  x += xVel;
+
+  if((x < 0) || (x + DOT_WIDTH > SCREEN_WIDTH))
+  {
+    xVel = -xVel;
+    x += xVel;
+  }
+
+  y += yVel;
+
+  if((y < 0) || (y + DOT_HEIGHT > SCREEN_HEIGHT))
+  {
+    yVel = -yVel;
+    y += yVel;
+  }
+}
+
+void Dot::show(DrawList &drawList)
+{
+  drawList.blit(x, y, sprite);
+}
+
+Timer::Timer()
+{
+  startTicks = 0;
+  pausedTicks = 0;
+  paused = false;
+  started = false;
+}
+
+void Timer::start()
+{
+  started = true;
+  paused = false;
+  startTicks = SDL_GetTicks();
+}
+
+void Timer::stop()
+{
+  started = false;
+  paused = false;
+}
+
+int Timer::get_ticks()
+{
+  if(started == true)
+  {
+    if(paused == true)
+    {
+      return pausedTicks;
+    }
+    else
+    {
+      return SDL_GetTicks() - startTicks;
+    }
+  }
+  return 0;
+}
+
+void Timer::pause()
+{
+  if((started == true) && (paused == false))
+  {
+    paused = true;
+    pausedTicks = SDL_GetTicks() - startTicks;
+  }
+}
+
+void Timer::unpause()
+{
+  if(paused == true)
+  {
+    paused = false;
+    startTicks = SDL_GetTicks() - pausedTicks;
+    pausedTicks = 0;
+  }
+}
+
+bool Timer::is_started()
+{
+  return started;
+}
+
+bool Timer::is_paused()
+{
+  return paused;
+}
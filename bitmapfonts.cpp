@@ -1,6 +1,7 @@
 #include "SDL/SDL.h"
 #include "SDL/SDL_image.h"
 #include <string>
+#include <algorithm>
 
 //Constants
 const int SCREEN_WIDTH = 640;
@@ -13,6 +14,24 @@ SDL_Surface *bitmapFont= NULL;
 SDL_Event event;
 
 //Structs/Classes
+
+//The text never changes, so the loop sleeps in SDL_WaitEvent() and only
+//redraws when an event marks part of the window invalid
+class DirtyRect
+{
+  private:
+    SDL_Rect area;
+    bool dirty;
+
+  public:
+    DirtyRect();
+    void invalidate(SDL_Rect rect);
+    void invalidate_all();
+    bool is_dirty();
+    SDL_Rect get_area();
+    void clear();
+};
+
 class BitmapFont
 {
   private:
@@ -40,6 +59,7 @@ Uint32 get_pixel32(int x, int y, SDL_Surface * surface);
 int main(int argc, char* args[])
 {
   bool quit = false;
+  DirtyRect dirty;
 
   if(init() == false)
   {
@@ -53,25 +73,47 @@ int main(int argc, char* args[])
   }
 
   BitmapFont font(bitmapFont);
-  SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
-  font.show_text(100, 100, "Bitmap Font:\nABCDEFGHIJKLMNOPQRSTUVWXYZ
-      \nabcdefghijklmnopqrstuvwxyz
-      \n-123456789", screen);
 
-    if(SDL_Flip(screen) == -1)
-    {
-      return 1;
-    }
+  //Everything needs drawing the first time
+  dirty.invalidate_all();
 
   //While user hasn't quit
   while(quit == false)
   {
-    while(SDL_PollEvent(&event))
+    if(dirty.is_dirty() == true)
     {
-      if(event.type == SDL_QUIT)
-      {
-        quit = true;
-      }
+      SDL_Rect area = dirty.get_area();
+
+      //Redraw only the invalid part and send only that to the window
+      SDL_SetClipRect(screen, &area);
+      SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+      font.show_text(100, 100, "Bitmap Font:\nABCDEFGHIJKLMNOPQRSTUVWXYZ
+          \nabcdefghijklmnopqrstuvwxyz
+          \n-123456789", screen);
+      SDL_SetClipRect(screen, NULL);
+
+      SDL_UpdateRect(screen, area.x, area.y, area.w, area.h);
+
+      dirty.clear();
+    }
+
+    //Sleep until something happens
+    if(SDL_WaitEvent(&event) == 0)
+    {
+      return 1;
+    }
+
+    if(event.type == SDL_QUIT)
+    {
+      quit = true;
+    }
+    else if(event.type == SDL_VIDEOEXPOSE)
+    {
+      dirty.invalidate_all();
+    }
+    else if((event.type == SDL_ACTIVEEVENT) && (event.active.gain == 1))
+    {
+      dirty.invalidate_all();
     }
   }
 
@@ -128,8 +170,8 @@ SDL_Surface *load_image(std::string filename)
 
 bool init()
 {
-  //Init SDL subsystems
-  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  //Only video is used; audio, joystick and CD-ROM would just slow startup
+  if(SDL_Init(SDL_INIT_VIDEO) == -1)
   {
     return false;
   }
@@ -166,6 +208,65 @@ void clean_up()
   SDL_Quit();
 }
 
+DirtyRect::DirtyRect()
+{
+  dirty = false;
+  area.x = 0;
+  area.y = 0;
+  area.w = 0;
+  area.h = 0;
+}
+
+void DirtyRect::invalidate(SDL_Rect rect)
+{
+  //Keep it on the screen so it can go straight to SDL_UpdateRect()
+  int left = std::max((int)rect.x, 0);
+  int top = std::max((int)rect.y, 0);
+  int right = std::min(rect.x + rect.w, SCREEN_WIDTH);
+  int bottom = std::min(rect.y + rect.h, SCREEN_HEIGHT);
+
+  if((left >= right) || (top >= bottom))
+  {
+    return;
+  }
+
+  //Grow the area to cover both
+  if(dirty == true)
+  {
+    left = std::min(left, (int)area.x);
+    top = std::min(top, (int)area.y);
+    right = std::max(right, area.x + area.w);
+    bottom = std::max(bottom, area.y + area.h);
+  }
+
+  area.x = left;
+  area.y = top;
+  area.w = right - left;
+  area.h = bottom - top;
+  dirty = true;
+}
+
+void DirtyRect::invalidate_all()
+{
+  SDL_Rect all = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+  invalidate(all);
+}
+
+bool DirtyRect::is_dirty()
+{
+  return dirty;
+}
+
+SDL_Rect DirtyRect::get_area()
+{
+  return area;
+}
+
+void DirtyRect::clear()
+{
+  dirty = false;
+}
+
 bool check_collision(SDL_Rect A, SDL_Rect B)
 {
   int leftA, leftB;
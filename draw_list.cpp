@@ -0,0 +1,1019 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <time.h>
+
+//The tiling lesson drawn through a frame draw list that starts with a
+//full screen clear, the way the particle engine and motion lessons do.
+//Draws are queued, not blitted. At submit the list works out which parts
+//of the screen opaque draws will cover. The clear shrinks to what is left,
+//which is nothing when tiles fill the view. Before that, a pass from the
+//last draw back to the first collects what opaque draws cover. Draws
+//entirely under later opaque ones are dropped. Partly hidden ones are cut
+//down to the pieces still showing, such as tiles under the panel.
+//The camera follows the dot past the level edge, so the clear sometimes
+//has real work left. A status panel covers the bottom of the screen.
+//C toggles coverage tracking to compare against clearing everything; the
+//caption shows pixels cleared, draws skipped and clipped and time spent
+//in submit.
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 20;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+
+const int LEVEL_WIDTH = 1280;
+const int LEVEL_HEIGHT = 960;
+const int TILE_WIDTH = 80;
+const int TILE_HEIGHT = 80;
+const int TOTAL_TILES = 192;
+const int TILE_SPRITES = 12;
+
+const int TILE_RED = 0;
+const int TILE_GREEN = 1;
+const int TILE_BLUE = 2;
+const int TILE_CENTER= 3;
+const int TILE_TOP= 4;
+const int TILE_TOPRIGHT= 5;
+const int TILE_RIGHT= 6;
+const int TILE_BOTTOMRIGHT= 7;
+const int TILE_BOTTOM= 8;
+const int TILE_BOTTOMLEFT= 9;
+const int TILE_LEFT= 10;
+const int TILE_TOPLEFT= 11;
+
+const int PANEL_HEIGHT = 100;
+
+//A draw left in more pieces than this is blitted as their bounding box;
+//past a few pieces the extra blit calls cost more than the overdraw
+const int MAX_PIECES = 4;
+
+//Globals
+SDL_Surface *dot = NULL;
+SDL_Surface *screen = NULL;
+SDL_Surface *tileSheet = NULL;
+
+SDL_Event event;
+
+SDL_Rect camera = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+SDL_Rect clips[TILE_SPRITES];
+
+//Tiles whose clip has no colour keyed pixel, worked out at load
+bool clipOpaque[TILE_SPRITES];
+
+//Structs/Classes
+struct DrawCommand
+{
+  SDL_Surface *source;
+
+  //Already clipped to the screen, with clip moved to match
+  SDL_Rect clip;
+  SDL_Rect area;
+
+  Uint32 color;
+  bool fill;
+  bool opaque;
+};
+
+class DrawList
+{
+  private:
+    std::vector<DrawCommand> commands;
+    bool clearing;
+    Uint32 clearColor;
+    bool tracking;
+
+    //Last submit
+    int clearedPixels;
+    int skippedDraws;
+    int clippedDraws;
+
+  public:
+    DrawList();
+    void clear(Uint32 color);
+    void blit(int x, int y, SDL_Surface *source, SDL_Rect *clip, bool opaque);
+    void fill(SDL_Rect area, Uint32 color);
+    void submit(SDL_Surface *destination);
+    void set_tracking(bool on);
+    bool is_tracking();
+    int get_cleared();
+    int get_skipped();
+    int get_clipped();
+};
+
+class Timer
+{
+  private:
+    int startTicks;
+    int pausedTicks;
+
+    bool paused;
+    bool started;
+
+  public:
+    Timer();
+    void start();
+    void stop();
+    void pause();
+    void unpause();
+    int get_ticks();
+    bool is_started();
+    bool is_paused();
+};
+
+class Tile
+{
+  private:
+    SDL_Rect box;
+    int type;
+
+  public:
+    Tile(int x, int y, int tileType);
+    void show();
+    int get_type();
+    SDL_Rect get_box();
+};
+
+class Dot
+{
+  private:
+    SDL_Rect box;
+    int xVel, yVel;
+
+  public:
+    Dot();
+    void handle_input();
+    void move(Tile *tiles[]);
+    void show();
+    void set_camera();
+};
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *load_image(std::string filename);
+bool load_files();
+void clean_up(Tile *tiles[]);
+void clip_tiles();
+void find_opaque_clips();
+bool set_tiles(Tile *tiles[]);
+bool touches_wall(SDL_Rect box, Tile *tiles[]);
+bool check_collision(SDL_Rect A, SDL_Rect B);
+bool intersect(SDL_Rect A, SDL_Rect B, SDL_Rect &result);
+void subtract_rect(std::vector<SDL_Rect> &region, SDL_Rect cut);
+bool is_opaque(SDL_Surface *surface, SDL_Rect clip);
+Sint64 now_nanoseconds();
+
+DrawList draws;
+
+//Functions
+int main(int argc, char* args[])
+{
+  Timer fps;
+  Dot myDot;
+  bool quit = false;
+  Tile *tiles[TOTAL_TILES];
+  int frame = 0;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  clip_tiles();
+  find_opaque_clips();
+
+  if(set_tiles(tiles) == false)
+  {
+    return 1;
+  }
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+
+    fps.start();
+
+    while(SDL_PollEvent(&event))
+    {
+      myDot.handle_input();
+
+      if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_c))
+      {
+        draws.set_tracking(!draws.is_tracking());
+      }
+
+      if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    myDot.move(tiles);
+    myDot.set_camera();
+
+    draws.clear(SDL_MapRGB(screen->format, 0, 0, 0));
+
+    for(int t = 0; t < TOTAL_TILES; t++)
+    {
+      tiles[t]->show();
+    }
+
+    myDot.show();
+
+    SDL_Rect panel = {0, SCREEN_HEIGHT - PANEL_HEIGHT, SCREEN_WIDTH, PANEL_HEIGHT};
+    draws.fill(panel, SDL_MapRGB(screen->format, 0x40, 0x40, 0x40));
+
+    Sint64 start = now_nanoseconds();
+    draws.submit(screen);
+    Sint64 submitTime = now_nanoseconds() - start;
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    frame++;
+
+    if(frame % FRAMES_PER_SECOND == 0)
+    {
+      std::stringstream caption;
+      caption << "Draw list, coverage " << (draws.is_tracking() ? "on" : "off");
+      caption << ": cleared " << draws.get_cleared() << " px, skipped " << draws.get_skipped();
+      caption << " draws, clipped " << draws.get_clipped() << ", submit " << submitTime / 1000 << " us";
+
+      SDL_WM_SetCaption(caption.str().c_str(), NULL);
+    }
+
+    if(fps.get_ticks() < 1000 / FRAMES_PER_SECOND)
+    {
+      SDL_Delay((1000 / FRAMES_PER_SECOND) - fps.get_ticks());
+    }
+  }
+
+  clean_up(tiles);
+  return 0;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Draw List", NULL);
+
+  srand(SDL_GetTicks());
+
+  return true;
+}
+
+bool load_files()
+{
+  dot = load_image("dot.png");
+
+  if(dot == NULL)
+  {
+    return false;
+  }
+
+  tileSheet = load_image("tiles.png");
+
+  if(tileSheet == NULL)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void find_opaque_clips()
+{
+  for(int t = 0; t < TILE_SPRITES; t++)
+  {
+    clipOpaque[t] = is_opaque(tileSheet, clips[t]);
+  }
+}
+
+void clean_up(Tile *tiles[])
+{
+  SDL_FreeSurface(dot);
+  SDL_FreeSurface(tileSheet);
+
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    delete tiles[t];
+  }
+
+  SDL_Quit();
+}
+
+void clip_tiles()
+{
+  clips[TILE_RED].x = 0;
+  clips[TILE_RED].y = 0;
+  clips[TILE_RED].w = TILE_WIDTH;
+  clips[TILE_RED].h = TILE_HEIGHT;
+
+  clips[TILE_GREEN].x = 0;
+  clips[TILE_GREEN].y = 80;
+  clips[TILE_GREEN].w = TILE_WIDTH;
+  clips[TILE_GREEN].h = TILE_HEIGHT;
+
+  clips[TILE_BLUE].x = 0;
+  clips[TILE_BLUE].y = 160;
+  clips[TILE_BLUE].w = TILE_WIDTH;
+  clips[TILE_BLUE].h = TILE_HEIGHT;
+
+  clips[TILE_TOPLEFT].x = 80;
+  clips[TILE_TOPLEFT].y = 0;
+  clips[TILE_TOPLEFT].w = TILE_WIDTH;
+  clips[TILE_TOPLEFT].h = TILE_HEIGHT;
+
+  clips[TILE_LEFT].x = 80;
+  clips[TILE_LEFT].y = 80;
+  clips[TILE_LEFT].w = TILE_WIDTH;
+  clips[TILE_LEFT].h = TILE_HEIGHT;
+
+  clips[TILE_BOTTOMLEFT].x = 80;
+  clips[TILE_BOTTOMLEFT].y = 160;
+  clips[TILE_BOTTOMLEFT].w = TILE_WIDTH;
+  clips[TILE_BOTTOMLEFT].h = TILE_HEIGHT;
+
+  clips[TILE_TOP].x = 160;
+  clips[TILE_TOP].y = 0;
+  clips[TILE_TOP].w = TILE_WIDTH;
+  clips[TILE_TOP].h = TILE_HEIGHT;
+
+  clips[TILE_CENTER].x = 160;
+  clips[TILE_CENTER].y = 80;
+  clips[TILE_CENTER].w = TILE_WIDTH;
+  clips[TILE_CENTER].h = TILE_HEIGHT;
+
+  clips[TILE_BOTTOM].x = 160;
+  clips[TILE_BOTTOM].y = 160;
+  clips[TILE_BOTTOM].w = TILE_WIDTH;
+  clips[TILE_BOTTOM].h = TILE_HEIGHT;
+
+  clips[TILE_TOPRIGHT].x = 240;
+  clips[TILE_TOPRIGHT].y = 0;
+  clips[TILE_TOPRIGHT].w = TILE_WIDTH;
+  clips[TILE_TOPRIGHT].h = TILE_HEIGHT;
+
+  clips[TILE_RIGHT].x = 240;
+  clips[TILE_RIGHT].y = 80;
+  clips[TILE_RIGHT].w = TILE_WIDTH;
+  clips[TILE_RIGHT].h = TILE_HEIGHT;
+
+  clips[TILE_BOTTOMRIGHT].x = 240;
+  clips[TILE_BOTTOMRIGHT].y = 160;
+  clips[TILE_BOTTOMRIGHT].w = TILE_WIDTH;
+  clips[TILE_BOTTOMRIGHT].h = TILE_HEIGHT;
+}
+
+bool touches_wall(SDL_Rect box, Tile *tiles[])
+{
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    if((tiles[t]->get_type() >= TILE_CENTER) && (tiles[t]->get_type() <= TILE_TOPLEFT))
+    {
+      if(check_collision(box, tiles[t]->get_box()) == true)
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool check_collision(SDL_Rect A, SDL_Rect B)
+{
+  int leftA, leftB;
+  int rightA, rightB;
+  int topA, topB;
+  int bottomA, bottomB;
+  leftA = A.x;
+  rightA = A.x + A.w;
+  topA = A.y;
+  bottomA = A.y + A.h;
+  leftB = B.x;
+  topB = B.y;
+  rightB = B.x + B.w;
+  bottomB = B.y + B.h;
+
+  if(bottomA <= topB)
+  {
+    return false;
+  }
+
+  if(topA >= bottomB)
+  {
+    return false;
+  }
+
+  if(rightA <= leftB)
+  {
+    return false;
+  }
+
+  if(leftA >= rightB)
+  {
+    return false;
+  }
+  return true;
+}
+
+Timer::Timer()
+{
+  startTicks = 0;
+  pausedTicks = 0;
+  paused = false;
+  started = false;
+}
+
+void Timer::start()
+{
+  started = true;
+  paused = false;
+  startTicks = SDL_GetTicks();
+}
+
+void Timer::stop()
+{
+  started = false;
+  paused = false;
+}
+
+int Timer::get_ticks()
+{
+  if(started == true)
+  {
+    if(paused == true)
+    {
+      return pausedTicks;
+    }
+    else
+    {
+      return SDL_GetTicks() - startTicks;
+    }
+  }
+  return 0;
+}
+
+void Timer::pause()
+{
+  if((started == true) && (paused == false))
+  {
+    paused = true;
+    pausedTicks = SDL_GetTicks() - startTicks;
+  }
+}
+
+void Timer::unpause()
+{
+  if(paused == true)
+  {
+    paused = false;
+    startTicks = SDL_GetTicks() - pausedTicks;
+    pausedTicks = 0;
+  }
+}
+
+bool Timer::is_started()
+{
+  return started;
+}
+
+bool Timer::is_paused()
+{
+  return paused;
+}
+
+Dot::Dot()
+{
+  box.x = 0;
+  box.y = 0;
+  box.w = DOT_WIDTH;
+  box.h = DOT_HEIGHT;
+  xVel = 0;
+  yVel = 0;
+}
+
+void Dot::set_camera()
+{
+  //Not held inside the level, so the edge of the world can come into view
+  camera.x = (box.x + DOT_WIDTH / 2) - SCREEN_WIDTH/2;
+  camera.y = (box.y + DOT_HEIGHT/ 2) - SCREEN_HEIGHT/2;
+}
+
+void Dot::handle_input()
+{
+  if(event.type == SDL_KEYDOWN)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel += DOT_WIDTH/ 2; break;
+      case SDLK_LEFT: xVel -= DOT_WIDTH/ 2; break;
+    }
+  }
+  else if(event.type == SDL_KEYUP)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel -= DOT_WIDTH/ 2; break;
+      case SDLK_LEFT: xVel += DOT_WIDTH/ 2; break;
+    }
+  }
+}
+
+void Dot::move(Tile *tiles[])
+{
+  box.x += xVel;
+  if((box.x < 0) || (box.x + DOT_WIDTH > LEVEL_WIDTH) || touches_wall(box, tiles))
+  {
+    box.x -= xVel;
+  }
+
+  box.y += yVel;
+
+  if((box.y < 0) || (box.y + DOT_HEIGHT > LEVEL_HEIGHT) || touches_wall(box, tiles))
+  {
+    box.y -= yVel;
+  }
+}
+
+void Dot::show()
+{
+  draws.blit(box.x - camera.x, box.y - camera.y, dot, NULL, false);
+}
+
+Tile::Tile(int x, int y, int tileType)
+{
+  box.x = x;
+  box.y = y;
+  box.w = TILE_WIDTH;
+  box.h = TILE_HEIGHT;
+  type = tileType;
+}
+
+void Tile::show()
+{
+  if(check_collision(camera, box) == true)
+  {
+    draws.blit(box.x - camera.x, box.y - camera.y, tileSheet, &clips[type], clipOpaque[type]);
+  }
+}
+
+int Tile::get_type()
+{
+  return type;
+}
+
+SDL_Rect Tile::get_box()
+{
+  return box;
+}
+
+bool set_tiles(Tile *tiles[])
+{
+  int x = 0, y = 0;
+  std::ifstream map("lazy.map");
+
+  if(map == NULL)
+  {
+    return false;
+  }
+
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    int tileType = -1;
+    map >> tileType;
+    if(map.fail() == true)
+    {
+      map.close();
+      return false;
+    }
+
+    if((tileType >= 0) && (tileType < TILE_SPRITES))
+    {
+      tiles[t] = new Tile(x, y, tileType);
+    }
+    else
+    {
+      map.close();
+      return false;
+    }
+
+    x += TILE_WIDTH;
+    if(x >= LEVEL_WIDTH)
+    {
+      x = 0;
+      y+= TILE_HEIGHT;
+    }
+  }
+
+  map.close();
+  return true;
+}
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+bool intersect(SDL_Rect A, SDL_Rect B, SDL_Rect &result)
+{
+  int left = std::max((int)A.x, (int)B.x);
+  int top = std::max((int)A.y, (int)B.y);
+  int right = std::min(A.x + A.w, B.x + B.w);
+  int bottom = std::min(A.y + A.h, B.y + B.h);
+
+  if((left >= right) || (top >= bottom))
+  {
+    return false;
+  }
+
+  result.x = left;
+  result.y = top;
+  result.w = right - left;
+  result.h = bottom - top;
+
+  return true;
+}
+
+void subtract_rect(std::vector<SDL_Rect> &region, SDL_Rect cut)
+{
+  //Each rectangle the cut touches becomes up to four: the bands above and
+  //below it, then what is left beside it between those bands
+  std::vector<SDL_Rect> left;
+
+  for(unsigned int r = 0; r < region.size(); r++)
+  {
+    SDL_Rect piece = region[r];
+    SDL_Rect overlap;
+
+    if(intersect(piece, cut, overlap) == false)
+    {
+      left.push_back(piece);
+      continue;
+    }
+
+    if(overlap.y > piece.y)
+    {
+      SDL_Rect above = piece;
+      above.h = overlap.y - piece.y;
+      left.push_back(above);
+    }
+
+    if(overlap.y + overlap.h < piece.y + piece.h)
+    {
+      SDL_Rect below = piece;
+      below.y = overlap.y + overlap.h;
+      below.h = (piece.y + piece.h) - (overlap.y + overlap.h);
+      left.push_back(below);
+    }
+
+    if(overlap.x > piece.x)
+    {
+      SDL_Rect before = overlap;
+      before.x = piece.x;
+      before.w = overlap.x - piece.x;
+      left.push_back(before);
+    }
+
+    if(overlap.x + overlap.w < piece.x + piece.w)
+    {
+      SDL_Rect after = overlap;
+      after.x = overlap.x + overlap.w;
+      after.w = (piece.x + piece.w) - (overlap.x + overlap.w);
+      left.push_back(after);
+    }
+  }
+
+  region.swap(left);
+}
+
+bool is_opaque(SDL_Surface *surface, SDL_Rect clip)
+{
+  //Per surface alpha or an alpha channel blends, so never opaque
+  if((surface->flags & SDL_SRCALPHA) != 0)
+  {
+    return false;
+  }
+
+  if((surface->flags & SDL_SRCCOLORKEY) == 0)
+  {
+    return true;
+  }
+
+  //Colour keyed, but only matters if the key shows up inside the clip
+  Uint32 key = surface->format->colorkey;
+  bool opaque = true;
+
+  SDL_LockSurface(surface);
+
+  for(int y = clip.y; (y < clip.y + clip.h) && (opaque == true); y++)
+  {
+    Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+
+    for(int x = clip.x; x < clip.x + clip.w; x++)
+    {
+      if(row[x] == key)
+      {
+        opaque = false;
+        break;
+      }
+    }
+  }
+
+  SDL_UnlockSurface(surface);
+
+  return opaque;
+}
+
+DrawList::DrawList()
+{
+  clearing = false;
+  clearColor = 0;
+  tracking = true;
+  clearedPixels = 0;
+  skippedDraws = 0;
+  clippedDraws = 0;
+}
+
+void DrawList::clear(Uint32 color)
+{
+  //Nothing is done yet, the clear happens in submit once coverage is known
+  clearing = true;
+  clearColor = color;
+}
+
+void DrawList::blit(int x, int y, SDL_Surface *source, SDL_Rect *clip, bool opaque)
+{
+  DrawCommand command;
+  command.source = source;
+  command.fill = false;
+  command.opaque = opaque;
+  command.color = 0;
+
+  SDL_Rect whole;
+  whole.x = 0;
+  whole.y = 0;
+  whole.w = source->w;
+  whole.h = source->h;
+
+  SDL_Rect from = (clip != NULL) ? *clip : whole;
+
+  SDL_Rect to;
+  to.x = x;
+  to.y = y;
+  to.w = from.w;
+  to.h = from.h;
+
+  SDL_Rect visible = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+
+  //Off screen draws never make the list
+  if(intersect(to, visible, command.area) == false)
+  {
+    return;
+  }
+
+  command.clip.x = from.x + (command.area.x - x);
+  command.clip.y = from.y + (command.area.y - y);
+  command.clip.w = command.area.w;
+  command.clip.h = command.area.h;
+
+  commands.push_back(command);
+}
+
+void DrawList::fill(SDL_Rect area, Uint32 color)
+{
+  DrawCommand command;
+  command.source = NULL;
+  command.fill = true;
+  command.opaque = true;
+  command.color = color;
+
+  SDL_Rect visible = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+
+  if(intersect(area, visible, command.area) == false)
+  {
+    return;
+  }
+
+  command.clip = command.area;
+  commands.push_back(command);
+}
+
+void DrawList::submit(SDL_Surface *destination)
+{
+  SDL_Rect screenArea = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+
+  //What each draw still shows once everything after it is down
+  std::vector< std::vector<SDL_Rect> > visible(commands.size());
+
+  //Screen painted by opaque draws so far, walking back to front; the
+  //rectangles never overlap because each is what was left uncovered
+  std::vector<SDL_Rect> covered;
+
+  clearedPixels = 0;
+  skippedDraws = 0;
+  clippedDraws = 0;
+
+  for(int c = (int)commands.size() - 1; c >= 0; c--)
+  {
+    std::vector<SDL_Rect> &pieces = visible[c];
+    pieces.push_back(commands[c].area);
+
+    if(tracking == false)
+    {
+      continue;
+    }
+
+    for(unsigned int k = 0; (k < covered.size()) && (pieces.empty() == false); k++)
+    {
+      subtract_rect(pieces, covered[k]);
+    }
+
+    if(pieces.empty() == true)
+    {
+      skippedDraws++;
+      continue;
+    }
+
+    if((pieces.size() > 1) || (pieces[0].w != commands[c].area.w) || (pieces[0].h != commands[c].area.h))
+    {
+      clippedDraws++;
+    }
+
+    if(commands[c].opaque == true)
+    {
+      covered.insert(covered.end(), pieces.begin(), pieces.end());
+    }
+
+    if(pieces.size() > (unsigned int)MAX_PIECES)
+    {
+      SDL_Rect bounds = pieces[0];
+
+      for(unsigned int p = 1; p < pieces.size(); p++)
+      {
+        int right = std::max(bounds.x + bounds.w, pieces[p].x + pieces[p].w);
+        int bottom = std::max(bounds.y + bounds.h, pieces[p].y + pieces[p].h);
+        bounds.x = std::min(bounds.x, pieces[p].x);
+        bounds.y = std::min(bounds.y, pieces[p].y);
+        bounds.w = right - bounds.x;
+        bounds.h = bottom - bounds.y;
+      }
+
+      pieces.assign(1, bounds);
+    }
+  }
+
+  if(clearing == true)
+  {
+    //Only what no opaque draw will paint over
+    std::vector<SDL_Rect> uncovered(1, screenArea);
+
+    for(unsigned int k = 0; (k < covered.size()) && (uncovered.empty() == false); k++)
+    {
+      subtract_rect(uncovered, covered[k]);
+    }
+
+    for(unsigned int r = 0; r < uncovered.size(); r++)
+    {
+      SDL_FillRect(destination, &uncovered[r], clearColor);
+      clearedPixels += uncovered[r].w * uncovered[r].h;
+    }
+  }
+
+  for(unsigned int c = 0; c < commands.size(); c++)
+  {
+    DrawCommand &command = commands[c];
+
+    for(unsigned int p = 0; p < visible[c].size(); p++)
+    {
+      SDL_Rect piece = visible[c][p];
+
+      if(command.fill == true)
+      {
+        SDL_FillRect(destination, &piece, command.color);
+        continue;
+      }
+
+      //Move the source clip by however much the piece moved in
+      SDL_Rect clip;
+      clip.x = command.clip.x + (piece.x - command.area.x);
+      clip.y = command.clip.y + (piece.y - command.area.y);
+      clip.w = piece.w;
+      clip.h = piece.h;
+
+      apply_surface(piece.x, piece.y, command.source, destination, &clip);
+    }
+  }
+
+  commands.clear();
+  clearing = false;
+}
+
+void DrawList::set_tracking(bool on)
+{
+  tracking = on;
+}
+
+bool DrawList::is_tracking()
+{
+  return tracking;
+}
+
+int DrawList::get_cleared()
+{
+  return clearedPixels;
+}
+
+int DrawList::get_skipped()
+{
+  return skippedDraws;
+}
+
+int DrawList::get_clipped()
+{
+  return clippedDraws;
+}
@@ -0,0 +1,1083 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <sched.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#else
+#define HAVE_RDTSC 0
+#endif
+
+//Blitters specialized at compile time, checked and timed against
+//SDL_BlitSurface(). SDL picks its blitter per call from the surface flags and
+//formats; for a 20x20 dot that setup costs more than copying the pixels.
+//Here blit_kernel is a template over bytes per pixel, blend mode and,
+//optionally, a fixed size. The fixed size instances unroll each row
+//completely. FastBlitter looks up the kernel once per source/destination
+//pair in a dispatch table, and only looks again when the source's colorkey
+//or alpha changes. Each blit clips the way SDL does, then runs the sized
+//kernel if the clipped rect matches one and the general one if not. Format
+//conversions, RLE surfaces and per-pixel alpha still go to SDL. The alpha
+//kernel uses the arithmetic of SDL's C blitter, checked at alpha 96 and 128.
+//Startup blits every scene with both paths onto the same noise and compares
+//the pixels, then times each one like microbench does.
+//Usage: fast_blit [filter] [repetitions] [cpu]
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+const int TILE_WIDTH = 80;
+const int TILE_HEIGHT = 80;
+const int FOO_WIDTH = 64;
+const int FOO_HEIGHT = 205;
+const int RANDOM_SEED = 1;
+
+//SDL blends most alphas with one blitter and 128 with an averaging one,
+//so the check covers both
+const int TILE_ALPHA = 96;
+const int TILE_ALPHA_HALF = 128;
+
+const int TOTAL_BLITS = 256;
+const int DEFAULT_REPETITIONS = 31;
+const int WARMUP_RUNS = 3;
+const int WARMUP_NANOSECONDS = 100000000;
+
+//Blend modes
+const int BLIT_COPY = 0;
+const int BLIT_COLORKEY = 1;
+const int BLIT_ALPHA = 2;
+
+//Ways to run a scene
+const int PATH_SDL = 0;
+const int PATH_FAST = 1;
+const int PATH_FAST_GENERAL = 2;
+
+const int MAX_SIZED_KERNELS = 4;
+
+//Globals
+SDL_Surface *screen = NULL;
+SDL_Surface *canvas = NULL;
+SDL_Surface *check = NULL;
+SDL_Surface *canvas16 = NULL;
+SDL_Surface *check16 = NULL;
+SDL_Surface *dot = NULL;
+SDL_Surface *dot16 = NULL;
+SDL_Surface *tileSheet = NULL;
+SDL_Surface *tileSheetAlpha = NULL;
+SDL_Surface *tileSheetHalf = NULL;
+SDL_Surface *foo = NULL;
+
+//Keeps results alive so the compiler can't drop the work
+volatile Uint32 sink = 0;
+
+//Structs/Classes
+struct BlitJob
+{
+  const Uint8 *source;
+  Uint8 *destination;
+  int sourcePitch;
+  int destinationPitch;
+  int w, h;
+  Uint32 key;
+  Uint32 keyMask;
+  Uint32 alpha;
+};
+
+typedef void (*BlitKernel)(const BlitJob &job);
+
+struct BlitEntry
+{
+  int bytes;
+  int mode;
+  int w, h;
+  BlitKernel kernel;
+  const char *name;
+};
+
+struct BlitPlan
+{
+  SDL_Surface *source;
+  SDL_Surface *destination;
+
+  //What the plan was made from; a change means looking again
+  Uint32 flags;
+  Uint32 colorkey;
+  Uint8 alpha;
+
+  //NULL when SDL has to do it
+  const BlitEntry *general;
+  const BlitEntry *sized[MAX_SIZED_KERNELS];
+  int totalSized;
+  BlitJob job;
+};
+
+class FastBlitter
+{
+  private:
+    std::vector<BlitPlan> plans;
+    unsigned int lastPlan;
+    bool useSized;
+
+    BlitPlan &plan_for(SDL_Surface *source, SDL_Surface *destination);
+    void prepare(BlitPlan &plan);
+
+  public:
+    FastBlitter();
+    int blit(SDL_Surface *source, SDL_Rect *clip, SDL_Surface *destination, SDL_Rect *offset);
+    const char *kernel_name(SDL_Surface *source, SDL_Surface *destination, int w, int h);
+    void forget(SDL_Surface *surface);
+    void set_sized(bool enabled);
+};
+
+struct Scene
+{
+  const char *name;
+  SDL_Surface **source;
+  std::vector<SDL_Rect> *clips;
+  SDL_Surface **target;
+  SDL_Surface **reference;
+};
+
+struct Benchmark
+{
+  int scene;
+  int path;
+  const char *name;
+};
+
+struct BenchmarkResult
+{
+  double median;
+  double spread;
+  double best;
+};
+
+//Pixel storage for each size
+template<int BYTES> struct Pixel;
+template<> struct Pixel<2> { typedef Uint16 type; };
+template<> struct Pixel<4> { typedef Uint32 type; };
+
+//One pixel; MODE is a constant, so only one branch survives
+template<int BYTES, int MODE>
+inline void blit_pixel(const typename Pixel<BYTES>::type *source, typename Pixel<BYTES>::type *destination, const BlitJob &job)
+{
+  if(MODE == BLIT_COPY)
+  {
+    *destination = *source;
+  }
+  else if(MODE == BLIT_COLORKEY)
+  {
+    if((*source & job.keyMask) != job.key)
+    {
+      *destination = *source;
+    }
+  }
+  else
+  {
+    //The arithmetic of SDL's C 8:8:8 surface alpha blitter. SDL may pick
+    //an MMX one instead; the startup check compares against whichever runs
+    Uint32 s = *source;
+    Uint32 d = *destination;
+    Uint32 s1 = s & 0xFF00FF;
+    Uint32 d1 = d & 0xFF00FF;
+
+    d1 = (d1 + ((s1 - d1) * job.alpha >> 8)) & 0xFF00FF;
+    s &= 0xFF00;
+    d &= 0xFF00;
+    d = (d + ((s - d) * job.alpha >> 8)) & 0xFF00;
+
+    *destination = d1 | d | 0xFF000000;
+  }
+}
+
+//A row of COUNT pixels with no loop left
+template<int BYTES, int MODE, int COUNT>
+struct UnrolledRow
+{
+  static inline void blit(const typename Pixel<BYTES>::type *source, typename Pixel<BYTES>::type *destination, const BlitJob &job)
+  {
+    blit_pixel<BYTES, MODE>(source, destination, job);
+    UnrolledRow<BYTES, MODE, COUNT - 1>::blit(source + 1, destination + 1, job);
+  }
+};
+
+template<int BYTES, int MODE>
+struct UnrolledRow<BYTES, MODE, 0>
+{
+  static inline void blit(const typename Pixel<BYTES>::type *, typename Pixel<BYTES>::type *, const BlitJob &)
+  {
+  }
+};
+
+//WIDTH and HEIGHT of 0 mean the size comes from the job
+template<int BYTES, int MODE, int WIDTH, int HEIGHT>
+void blit_kernel(const BlitJob &job)
+{
+  typedef typename Pixel<BYTES>::type PixelType;
+
+  const Uint8 *source = job.source;
+  Uint8 *destination = job.destination;
+  int h = (HEIGHT > 0) ? HEIGHT : job.h;
+
+  for(int y = 0; y < h; y++)
+  {
+    if(WIDTH > 0)
+    {
+      UnrolledRow<BYTES, MODE, WIDTH>::blit((const PixelType *)source, (PixelType *)destination, job);
+    }
+    else
+    {
+      for(int x = 0; x < job.w; x++)
+      {
+        blit_pixel<BYTES, MODE>((const PixelType *)source + x, (PixelType *)destination + x, job);
+      }
+    }
+
+    source += job.sourcePitch;
+    destination += job.destinationPitch;
+  }
+}
+
+//Every instance there is; sized ones only for the sprites the lessons draw
+BlitEntry blitKernels[] =
+{
+  {2, BLIT_COPY, 0, 0, blit_kernel<2, BLIT_COPY, 0, 0>, "16 bit copy"},
+  {2, BLIT_COLORKEY, 0, 0, blit_kernel<2, BLIT_COLORKEY, 0, 0>, "16 bit colorkey"},
+  {2, BLIT_COLORKEY, DOT_WIDTH, DOT_HEIGHT, blit_kernel<2, BLIT_COLORKEY, DOT_WIDTH, DOT_HEIGHT>, "16 bit colorkey 20x20"},
+  {4, BLIT_COPY, 0, 0, blit_kernel<4, BLIT_COPY, 0, 0>, "32 bit copy"},
+  {4, BLIT_COPY, TILE_WIDTH, TILE_HEIGHT, blit_kernel<4, BLIT_COPY, TILE_WIDTH, TILE_HEIGHT>, "32 bit copy 80x80"},
+  {4, BLIT_COLORKEY, 0, 0, blit_kernel<4, BLIT_COLORKEY, 0, 0>, "32 bit colorkey"},
+  {4, BLIT_COLORKEY, DOT_WIDTH, DOT_HEIGHT, blit_kernel<4, BLIT_COLORKEY, DOT_WIDTH, DOT_HEIGHT>, "32 bit colorkey 20x20"},
+  {4, BLIT_COLORKEY, TILE_WIDTH, TILE_HEIGHT, blit_kernel<4, BLIT_COLORKEY, TILE_WIDTH, TILE_HEIGHT>, "32 bit colorkey 80x80"},
+  {4, BLIT_COLORKEY, FOO_WIDTH, FOO_HEIGHT, blit_kernel<4, BLIT_COLORKEY, FOO_WIDTH, FOO_HEIGHT>, "32 bit colorkey 64x205"},
+  {4, BLIT_ALPHA, 0, 0, blit_kernel<4, BLIT_ALPHA, 0, 0>, "32 bit alpha"},
+  {4, BLIT_ALPHA, TILE_WIDTH, TILE_HEIGHT, blit_kernel<4, BLIT_ALPHA, TILE_WIDTH, TILE_HEIGHT>, "32 bit alpha 80x80"}
+};
+
+const int TOTAL_KERNELS = sizeof(blitKernels) / sizeof(blitKernels[0]);
+
+FastBlitter blitter;
+
+//Inputs, all built from RANDOM_SEED
+std::vector<SDL_Rect> tileClips;
+std::vector<SDL_Rect> fooClips;
+std::vector<SDL_Rect> spots;
+
+Scene scenes[] =
+{
+  {"dot 20x20 colorkey", &dot, NULL, &canvas, &check},
+  {"tile 80x80 colorkey", &tileSheet, &tileClips, &canvas, &check},
+  {"Foo 64x205 colorkey", &foo, &fooClips, &canvas, &check},
+  {"tile 80x80 alpha", &tileSheetAlpha, &tileClips, &canvas, &check},
+  {"tile 80x80 alpha 128", &tileSheetHalf, &tileClips, &canvas, &check},
+  {"dot 20x20 colorkey 16 bit", &dot16, NULL, &canvas16, &check16}
+};
+
+const int TOTAL_SCENES = sizeof(scenes) / sizeof(scenes[0]);
+
+Benchmark benchmarks[] =
+{
+  {0, PATH_SDL, "SDL_BlitSurface"},
+  {0, PATH_FAST, "fast_blit"},
+  {0, PATH_FAST_GENERAL, "fast_blit, no sized kernels"},
+  {1, PATH_SDL, "SDL_BlitSurface"},
+  {1, PATH_FAST, "fast_blit"},
+  {1, PATH_FAST_GENERAL, "fast_blit, no sized kernels"},
+  {2, PATH_SDL, "SDL_BlitSurface"},
+  {2, PATH_FAST, "fast_blit"},
+  {2, PATH_FAST_GENERAL, "fast_blit, no sized kernels"},
+  {3, PATH_SDL, "SDL_BlitSurface"},
+  {3, PATH_FAST, "fast_blit"},
+  {3, PATH_FAST_GENERAL, "fast_blit, no sized kernels"},
+  {4, PATH_SDL, "SDL_BlitSurface"},
+  {4, PATH_FAST, "fast_blit"},
+  {4, PATH_FAST_GENERAL, "fast_blit, no sized kernels"},
+  {5, PATH_SDL, "SDL_BlitSurface"},
+  {5, PATH_FAST, "fast_blit"},
+  {5, PATH_FAST_GENERAL, "fast_blit, no sized kernels"}
+};
+
+const int TOTAL_BENCHMARKS = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+//Prototypes
+bool init();
+void clean_up();
+void free_surface(SDL_Surface *surface);
+SDL_Surface *make_translucent(SDL_Surface *sheet, Uint8 alpha);
+SDL_Surface *load_image(std::string filename);
+void build_inputs();
+void add_clips(std::vector<SDL_Rect> &clips, SDL_Surface *sheet, int w, int h);
+Sint64 now_nanoseconds();
+Uint64 read_cycles();
+bool pin_to_cpu(int cpu);
+bool have_scene(Scene &scene);
+Uint32 run_scene(Scene &scene, int path, SDL_Surface *target);
+void fill_noise(SDL_Surface *surface);
+int count_differences(SDL_Surface *A, SDL_Surface *B);
+BenchmarkResult measure(Benchmark &benchmark, int repetitions);
+
+//Functions
+int main(int argc, char* args[])
+{
+  std::string filter;
+  int repetitions = DEFAULT_REPETITIONS;
+  int cpu = sched_getcpu();
+  bool mismatch = false;
+
+  if(argc > 1)
+  {
+    filter = args[1];
+  }
+
+  if(argc > 2)
+  {
+    repetitions = atoi(args[2]);
+  }
+
+  if(argc > 3)
+  {
+    cpu = atoi(args[3]);
+  }
+
+  if(repetitions <= 0)
+  {
+    std::cerr << "Usage: " << args[0] << " [filter] [repetitions] [cpu]" << std::endl;
+    return 1;
+  }
+
+  if(pin_to_cpu(cpu) == false)
+  {
+    std::cerr << "Could not pin to CPU " << cpu << ", results will be noisier" << std::endl;
+  }
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  build_inputs();
+
+  //Which of SDL's alpha blitters the check is up against
+  std::cout << "SDL alpha blits: " << (SDL_HasMMX() ? "MMX if SDL was built with it" : "C") << std::endl;
+
+  //Same noise under both, then every blit of the scene each way
+  for(int s = 0; s < TOTAL_SCENES; s++)
+  {
+    Scene &scene = scenes[s];
+
+    if(have_scene(scene) == false)
+    {
+      continue;
+    }
+
+    fill_noise(*scene.target);
+    fill_noise(*scene.reference);
+    run_scene(scene, PATH_SDL, *scene.reference);
+    run_scene(scene, PATH_FAST, *scene.target);
+
+    SDL_Rect first = (scene.clips == NULL) ? (*scene.source)->clip_rect : (*scene.clips)[0];
+    int differences = count_differences(*scene.target, *scene.reference);
+
+    std::cout << scene.name << ": " << blitter.kernel_name(*scene.source, *scene.target, first.w, first.h);
+
+    if(differences == 0)
+    {
+      std::cout << ", matches SDL" << std::endl;
+    }
+    else
+    {
+      std::cout << ", " << differences << " pixels differ from SDL" << std::endl;
+      mismatch = true;
+    }
+  }
+
+  std::cout.setf(std::ios::fixed);
+  std::cout.precision(2);
+
+  std::cout << std::endl << "CPU " << cpu << ", " << repetitions << " repetitions, ";
+  std::cout << (HAVE_RDTSC ? "TSC cycles" : "nanoseconds") << " per blit" << std::endl;
+
+  int scene = -1;
+  double baseline = 0;
+
+  for(int b = 0; b < TOTAL_BENCHMARKS; b++)
+  {
+    Benchmark &benchmark = benchmarks[b];
+
+    if((filter.empty() == false) && (std::string(scenes[benchmark.scene].name).find(filter) == std::string::npos))
+    {
+      continue;
+    }
+
+    if(have_scene(scenes[benchmark.scene]) == false)
+    {
+      if(scene != benchmark.scene)
+      {
+        scene = benchmark.scene;
+        std::cout << std::endl << scenes[scene].name << ": skipped, assets missing" << std::endl;
+      }
+
+      continue;
+    }
+
+    BenchmarkResult result = measure(benchmark, repetitions);
+
+    //SDL's time is what the rest of the scene is compared to
+    if(scene != benchmark.scene)
+    {
+      scene = benchmark.scene;
+      baseline = result.median;
+      std::cout << std::endl << scenes[scene].name << std::endl;
+    }
+
+    std::cout << "  " << benchmark.name;
+    std::cout << "\tmedian " << result.median << " +- " << result.spread;
+    std::cout << "\tbest " << result.best;
+
+    if(result.median > 0)
+    {
+      std::cout << "\tx" << baseline / result.median;
+    }
+
+    std::cout << std::endl;
+  }
+
+  clean_up();
+
+  if(mismatch == true)
+  {
+    return 1;
+  }
+
+  return 0;
+}
+
+FastBlitter::FastBlitter()
+{
+  lastPlan = 0;
+  useSized = true;
+}
+
+BlitPlan &FastBlitter::plan_for(SDL_Surface *source, SDL_Surface *destination)
+{
+  //Sprites come in runs, so the last pair is the usual hit
+  if((lastPlan >= plans.size()) || (plans[lastPlan].source != source) || (plans[lastPlan].destination != destination))
+  {
+    for(lastPlan = 0; lastPlan < plans.size(); lastPlan++)
+    {
+      if((plans[lastPlan].source == source) && (plans[lastPlan].destination == destination))
+      {
+        break;
+      }
+    }
+  }
+
+  if(lastPlan < plans.size())
+  {
+    BlitPlan &plan = plans[lastPlan];
+
+    //SDL_SetColorKey() and SDL_SetAlpha() change which kernel applies
+    if((plan.flags != source->flags) || (plan.colorkey != source->format->colorkey) || (plan.alpha != source->format->alpha))
+    {
+      prepare(plan);
+    }
+
+    return plan;
+  }
+
+  BlitPlan plan;
+  plan.source = source;
+  plan.destination = destination;
+  prepare(plan);
+
+  plans.push_back(plan);
+  lastPlan = plans.size() - 1;
+
+  return plans[lastPlan];
+}
+
+void FastBlitter::prepare(BlitPlan &plan)
+{
+  SDL_PixelFormat *source = plan.source->format;
+  SDL_PixelFormat *destination = plan.destination->format;
+
+  plan.flags = plan.source->flags;
+  plan.colorkey = source->colorkey;
+  plan.alpha = source->alpha;
+  plan.general = NULL;
+  plan.totalSized = 0;
+
+  //Only same format pairs; conversions are SDL's job
+  if((source->BytesPerPixel != destination->BytesPerPixel) || (source->Rmask != destination->Rmask) ||
+     (source->Gmask != destination->Gmask) || (source->Bmask != destination->Bmask))
+  {
+    return;
+  }
+
+  //RLE pixels aren't plain rows, and locking would undo the encoding
+  if(((plan.flags & SDL_RLEACCEL) != 0) || (SDL_MUSTLOCK(plan.source)) || (SDL_MUSTLOCK(plan.destination)))
+  {
+    return;
+  }
+
+  //The mode SDL would pick: opaque surface alpha counts as no alpha
+  bool keyed = (plan.flags & SDL_SRCCOLORKEY) != 0;
+  bool blended = ((plan.flags & SDL_SRCALPHA) != 0) && ((source->alpha != SDL_ALPHA_OPAQUE) || (source->Amask != 0));
+  int mode = BLIT_COPY;
+
+  if(blended == true)
+  {
+    if((keyed == true) || (source->Amask != 0) || ((source->Rmask | source->Gmask | source->Bmask) != 0xFFFFFF))
+    {
+      return;
+    }
+
+    mode = BLIT_ALPHA;
+  }
+  else if(keyed == true)
+  {
+    mode = BLIT_COLORKEY;
+  }
+
+  for(int k = 0; k < TOTAL_KERNELS; k++)
+  {
+    BlitEntry &entry = blitKernels[k];
+
+    if((entry.bytes != source->BytesPerPixel) || (entry.mode != mode))
+    {
+      continue;
+    }
+
+    if(entry.w == 0)
+    {
+      plan.general = &entry;
+    }
+    else if(plan.totalSized < MAX_SIZED_KERNELS)
+    {
+      plan.sized[plan.totalSized] = &entry;
+      plan.totalSized++;
+    }
+  }
+
+  plan.job.sourcePitch = plan.source->pitch;
+  plan.job.destinationPitch = plan.destination->pitch;
+  plan.job.keyMask = ~source->Amask;
+  plan.job.key = source->colorkey & plan.job.keyMask;
+  plan.job.alpha = source->alpha;
+}
+
+int FastBlitter::blit(SDL_Surface *source, SDL_Rect *clip, SDL_Surface *destination, SDL_Rect *offset)
+{
+  BlitPlan &plan = plan_for(source, destination);
+
+  if(plan.general == NULL)
+  {
+    return SDL_BlitSurface(source, clip, destination, offset);
+  }
+
+  SDL_Rect origin = {0, 0, 0, 0};
+
+  if(offset == NULL)
+  {
+    offset = &origin;
+  }
+
+  //Clip the way SDL_BlitSurface() does, source first
+  int sourceX = 0;
+  int sourceY = 0;
+  int w = source->w;
+  int h = source->h;
+
+  if(clip != NULL)
+  {
+    sourceX = clip->x;
+    w = clip->w;
+
+    if(sourceX < 0)
+    {
+      w += sourceX;
+      offset->x -= sourceX;
+      sourceX = 0;
+    }
+
+    if(w > source->w - sourceX)
+    {
+      w = source->w - sourceX;
+    }
+
+    sourceY = clip->y;
+    h = clip->h;
+
+    if(sourceY < 0)
+    {
+      h += sourceY;
+      offset->y -= sourceY;
+      sourceY = 0;
+    }
+
+    if(h > source->h - sourceY)
+    {
+      h = source->h - sourceY;
+    }
+  }
+
+  //Then against the destination's clip rect
+  SDL_Rect &bounds = destination->clip_rect;
+  int cut = bounds.x - offset->x;
+
+  if(cut > 0)
+  {
+    w -= cut;
+    offset->x += cut;
+    sourceX += cut;
+  }
+
+  cut = offset->x + w - bounds.x - bounds.w;
+
+  if(cut > 0)
+  {
+    w -= cut;
+  }
+
+  cut = bounds.y - offset->y;
+
+  if(cut > 0)
+  {
+    h -= cut;
+    offset->y += cut;
+    sourceY += cut;
+  }
+
+  cut = offset->y + h - bounds.y - bounds.h;
+
+  if(cut > 0)
+  {
+    h -= cut;
+  }
+
+  if((w <= 0) || (h <= 0))
+  {
+    offset->w = 0;
+    offset->h = 0;
+    return 0;
+  }
+
+  offset->w = w;
+  offset->h = h;
+
+  int bytes = source->format->BytesPerPixel;
+  BlitJob job = plan.job;
+  job.source = (const Uint8 *)source->pixels + sourceY * source->pitch + sourceX * bytes;
+  job.destination = (Uint8 *)destination->pixels + offset->y * destination->pitch + offset->x * bytes;
+  job.w = w;
+  job.h = h;
+
+  BlitKernel kernel = plan.general->kernel;
+
+  if(useSized == true)
+  {
+    for(int k = 0; k < plan.totalSized; k++)
+    {
+      if((plan.sized[k]->w == w) && (plan.sized[k]->h == h))
+      {
+        kernel = plan.sized[k]->kernel;
+        break;
+      }
+    }
+  }
+
+  kernel(job);
+
+  return 0;
+}
+
+const char *FastBlitter::kernel_name(SDL_Surface *source, SDL_Surface *destination, int w, int h)
+{
+  BlitPlan &plan = plan_for(source, destination);
+
+  if(plan.general == NULL)
+  {
+    return "SDL_BlitSurface";
+  }
+
+  for(int k = 0; (useSized == true) && (k < plan.totalSized); k++)
+  {
+    if((plan.sized[k]->w == w) && (plan.sized[k]->h == h))
+    {
+      return plan.sized[k]->name;
+    }
+  }
+
+  return plan.general->name;
+}
+
+void FastBlitter::forget(SDL_Surface *surface)
+{
+  //A freed surface's address can come back as a different surface
+  for(unsigned int p = 0; p < plans.size(); )
+  {
+    if((plans[p].source == surface) || (plans[p].destination == surface))
+    {
+      plans.erase(plans.begin() + p);
+    }
+    else
+    {
+      p++;
+    }
+  }
+
+  lastPlan = 0;
+}
+
+void FastBlitter::set_sized(bool enabled)
+{
+  useSized = enabled;
+}
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+Uint64 read_cycles()
+{
+#if HAVE_RDTSC
+  return __rdtsc();
+#else
+  return now_nanoseconds();
+#endif
+}
+
+bool pin_to_cpu(int cpu)
+{
+  if(cpu < 0)
+  {
+    return false;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+bool have_scene(Scene &scene)
+{
+  if((*scene.source == NULL) || (*scene.target == NULL) || (*scene.reference == NULL))
+  {
+    return false;
+  }
+
+  return (scene.clips == NULL) || (scene.clips->empty() == false);
+}
+
+Uint32 run_scene(Scene &scene, int path, SDL_Surface *target)
+{
+  blitter.set_sized(path != PATH_FAST_GENERAL);
+
+  for(int b = 0; b < TOTAL_BLITS; b++)
+  {
+    SDL_Rect offset = spots[b];
+    SDL_Rect *clip = NULL;
+
+    if(scene.clips != NULL)
+    {
+      clip = &(*scene.clips)[b % scene.clips->size()];
+    }
+
+    if(path == PATH_SDL)
+    {
+      SDL_BlitSurface(*scene.source, clip, target, &offset);
+    }
+    else
+    {
+      blitter.blit(*scene.source, clip, target, &offset);
+    }
+  }
+
+  blitter.set_sized(true);
+
+  return *(Uint8 *)target->pixels;
+}
+
+void fill_noise(SDL_Surface *surface)
+{
+  //Same seed every time, so two surfaces get the same noise
+  srand(RANDOM_SEED);
+
+  for(int y = 0; y < surface->h; y++)
+  {
+    Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+
+    for(int x = 0; x < surface->w * surface->format->BytesPerPixel; x++)
+    {
+      row[x] = rand();
+    }
+  }
+}
+
+int count_differences(SDL_Surface *A, SDL_Surface *B)
+{
+  //Bits outside the format, like the top byte of XRGB, don't count
+  SDL_PixelFormat *format = A->format;
+  Uint32 used = format->Rmask | format->Gmask | format->Bmask | format->Amask;
+  int differences = 0;
+
+  for(int y = 0; y < A->h; y++)
+  {
+    Uint8 *rowA = (Uint8 *)A->pixels + y * A->pitch;
+    Uint8 *rowB = (Uint8 *)B->pixels + y * B->pitch;
+
+    for(int x = 0; x < A->w; x++)
+    {
+      Uint32 pixelA = 0;
+      Uint32 pixelB = 0;
+
+      if(format->BytesPerPixel == 2)
+      {
+        pixelA = ((Uint16 *)rowA)[x];
+        pixelB = ((Uint16 *)rowB)[x];
+      }
+      else
+      {
+        pixelA = ((Uint32 *)rowA)[x];
+        pixelB = ((Uint32 *)rowB)[x];
+      }
+
+      if(((pixelA ^ pixelB) & used) != 0)
+      {
+        differences++;
+      }
+    }
+  }
+
+  return differences;
+}
+
+BenchmarkResult measure(Benchmark &benchmark, int repetitions)
+{
+  Scene &scene = scenes[benchmark.scene];
+
+  //Warm caches, branch predictors and the CPU clock before counting
+  Sint64 warmupStart = now_nanoseconds();
+
+  for(int w = 0; (w < WARMUP_RUNS) || (now_nanoseconds() - warmupStart < WARMUP_NANOSECONDS); w++)
+  {
+    sink += run_scene(scene, benchmark.path, *scene.target);
+  }
+
+  std::vector<double> perBlit;
+
+  for(int r = 0; r < repetitions; r++)
+  {
+    Uint64 start = read_cycles();
+    sink += run_scene(scene, benchmark.path, *scene.target);
+    Uint64 length = read_cycles() - start;
+
+    perBlit.push_back((double)length / TOTAL_BLITS);
+  }
+
+  std::sort(perBlit.begin(), perBlit.end());
+
+  BenchmarkResult result;
+  result.median = perBlit[perBlit.size() / 2];
+  result.best = perBlit[0];
+
+  //Median absolute deviation, not thrown off by the odd interrupt
+  std::vector<double> deviation;
+
+  for(unsigned int r = 0; r < perBlit.size(); r++)
+  {
+    deviation.push_back(fabs(perBlit[r] - result.median));
+  }
+
+  std::sort(deviation.begin(), deviation.end());
+  result.spread = deviation[deviation.size() / 2];
+
+  return result;
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //SDL_DisplayFormat() needs a video mode, not a window
+  if(getenv("SDL_VIDEODRIVER") == NULL)
+  {
+    putenv((char *)"SDL_VIDEODRIVER=dummy");
+  }
+
+  if(SDL_Init(SDL_INIT_VIDEO) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  //Blits go to plain surfaces in the screen's format
+  canvas = SDL_DisplayFormat(screen);
+  check = SDL_DisplayFormat(screen);
+
+  //And a 5:6:5 pair for the 16 bit kernels
+  canvas16 = SDL_CreateRGBSurface(SDL_SWSURFACE, SCREEN_WIDTH, SCREEN_HEIGHT, 16, 0xF800, 0x07E0, 0x001F, 0);
+  check16 = SDL_CreateRGBSurface(SDL_SWSURFACE, SCREEN_WIDTH, SCREEN_HEIGHT, 16, 0xF800, 0x07E0, 0x001F, 0);
+
+  if((canvas == NULL) || (check == NULL) || (canvas16 == NULL) || (check16 == NULL))
+  {
+    return false;
+  }
+
+  //Missing sheets only skip the scenes that need them
+  dot = load_image("dot.bmp");
+  tileSheet = load_image("tiles.png");
+  foo = load_image("foo.png");
+
+  if(dot != NULL)
+  {
+    dot16 = SDL_ConvertSurface(dot, canvas16->format, SDL_SWSURFACE);
+
+    if(dot16 != NULL)
+    {
+      SDL_SetColorKey(dot16, SDL_SRCCOLORKEY, SDL_MapRGB(dot16->format, 0, 0xFF, 0xFF));
+    }
+  }
+
+  //The tiles again, see through instead of keyed
+  if(tileSheet != NULL)
+  {
+    tileSheetAlpha = make_translucent(tileSheet, TILE_ALPHA);
+    tileSheetHalf = make_translucent(tileSheet, TILE_ALPHA_HALF);
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  free_surface(canvas);
+  free_surface(check);
+  free_surface(canvas16);
+  free_surface(check16);
+  free_surface(dot);
+  free_surface(dot16);
+  free_surface(tileSheet);
+  free_surface(tileSheetAlpha);
+  free_surface(tileSheetHalf);
+  free_surface(foo);
+
+  SDL_Quit();
+}
+
+void free_surface(SDL_Surface *surface)
+{
+  //Plans hold the pointer, and a new surface could reuse the address
+  blitter.forget(surface);
+  SDL_FreeSurface(surface);
+}
+
+SDL_Surface *make_translucent(SDL_Surface *sheet, Uint8 alpha)
+{
+  SDL_Surface *translucent = SDL_DisplayFormat(sheet);
+
+  if(translucent != NULL)
+  {
+    SDL_SetColorKey(translucent, 0, 0);
+    SDL_SetAlpha(translucent, SDL_SRCALPHA, alpha);
+  }
+
+  return translucent;
+}
+
+void add_clips(std::vector<SDL_Rect> &clips, SDL_Surface *sheet, int w, int h)
+{
+  if(sheet == NULL)
+  {
+    return;
+  }
+
+  for(int y = 0; y + h <= sheet->h; y += h)
+  {
+    for(int x = 0; x + w <= sheet->w; x += w)
+    {
+      SDL_Rect clip;
+      clip.x = x;
+      clip.y = y;
+      clip.w = w;
+      clip.h = h;
+      clips.push_back(clip);
+    }
+  }
+}
+
+void build_inputs()
+{
+  srand(RANDOM_SEED);
+
+  //Every tile and every Foo frame in the sheets
+  add_clips(tileClips, tileSheet, TILE_WIDTH, TILE_HEIGHT);
+  add_clips(fooClips, foo, FOO_WIDTH, FOO_HEIGHT);
+
+  //Mostly on screen, some hanging off an edge to exercise clipping
+  for(int b = 0; b < TOTAL_BLITS; b++)
+  {
+    SDL_Rect spot;
+    spot.x = rand() % SCREEN_WIDTH - TILE_WIDTH / 2;
+    spot.y = rand() % SCREEN_HEIGHT - TILE_HEIGHT / 2;
+    spot.w = 0;
+    spot.h = 0;
+    spots.push_back(spot);
+  }
+}
@@ -0,0 +1,444 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+
+//The motion lesson with the simulation decoupled from the frame rate.
+//The dot moves in fixed steps of 1000 / TICKS_PER_SECOND ms, fed from an
+//accumulator of real time, and is drawn between its last two positions.
+//Return toggles the render cap, space fakes a slow frame.
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 60;
+const int TICKS_PER_SECOND = 30;
+const int DOT_HEIGHT = 20;
+const int DOT_WIDTH = 20;
+
+//Pixels per second
+const int DOT_VEL = 200;
+
+//Longest stretch of real time one frame may catch up on
+const int MAX_FRAME_TICKS = 250;
+
+SDL_Surface *dot = NULL;
+SDL_Surface *screen = NULL;
+
+SDL_Event event;
+
+class Timer
+{
+  private:
+    int startTicks;
+    int pausedTicks;
+
+    bool paused;
+    bool started;
+
+  public:
+    Timer();
+    void start();
+    void stop();
+    void pause();
+    void unpause();
+    int get_ticks();
+    bool is_started();
+    bool is_paused();
+};
+
+class FixedTimestep
+{
+  private:
+    int tickLength;
+    int accumulator;
+    Uint32 lastTicks;
+
+  public:
+    FixedTimestep(int ticksPerSecond);
+    void start();
+    int advance();
+    float get_alpha();
+    float get_step();
+};
+
+class Dot
+{
+  private:
+    float x, y;
+    float prevX, prevY;
+    int xVel, yVel;
+
+  public:
+    Dot();
+    void handle_input();
+    void move(float step);
+    void show(float alpha);
+};
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  //Return the optimized image
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  //Set up screen
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  //If there was an error setting up the screen
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Fixed Timestep", NULL);
+
+  return true;
+}
+
+bool load_files()
+{
+  //Load image
+  dot = load_image("dot.bmp");
+
+  //If there was an error loading the images
+  if(dot == NULL)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  //Free the images
+  SDL_FreeSurface(dot);
+
+  SDL_Quit();
+}
+
+Timer::Timer()
+{
+  startTicks = 0;
+  pausedTicks = 0;
+  paused = false;
+  started = false;
+}
+
+void Timer::start()
+{
+  started = true;
+  paused = false;
+  startTicks = SDL_GetTicks();
+}
+
+void Timer::stop()
+{
+  started = false;
+  paused = false;
+}
+
+int Timer::get_ticks()
+{
+  if(started == true)
+  {
+    if(paused == true)
+    {
+      return pausedTicks;
+    }
+    else
+    {
+      return SDL_GetTicks() - startTicks;
+    }
+  }
+  return 0;
+}
+
+void Timer::pause()
+{
+  if((started == true) && (paused == false))
+  {
+    paused = true;
+    pausedTicks = SDL_GetTicks() - startTicks;
+  }
+}
+
+void Timer::unpause()
+{
+  if(paused == true)
+  {
+    paused = false;
+    startTicks = SDL_GetTicks() - pausedTicks;
+    pausedTicks = 0;
+  }
+}
+
+bool Timer::is_started()
+{
+  return started;
+}
+
+bool Timer::is_paused()
+{
+  return paused;
+}
+
+FixedTimestep::FixedTimestep(int ticksPerSecond)
+{
+  tickLength = 1000 / ticksPerSecond;
+  accumulator = 0;
+  lastTicks = 0;
+}
+
+void FixedTimestep::start()
+{
+  accumulator = 0;
+  lastTicks = SDL_GetTicks();
+}
+
+int FixedTimestep::advance()
+{
+  //Bank the real time since the last frame, return how many steps it buys
+  Uint32 now = SDL_GetTicks();
+  int frameTicks = now - lastTicks;
+  lastTicks = now;
+
+  //After a long stall drop the backlog instead of simulating it all at once
+  if(frameTicks > MAX_FRAME_TICKS)
+  {
+    frameTicks = MAX_FRAME_TICKS;
+  }
+
+  accumulator += frameTicks;
+
+  int steps = accumulator / tickLength;
+  accumulator -= steps * tickLength;
+
+  return steps;
+}
+
+float FixedTimestep::get_alpha()
+{
+  //How far between the last two steps the current frame lies
+  return (float)accumulator / tickLength;
+}
+
+float FixedTimestep::get_step()
+{
+  return tickLength / 1000.f;
+}
+
+Dot::Dot()
+{
+  x = 0;
+  y = 0;
+  prevX = 0;
+  prevY = 0;
+
+  xVel = 0;
+  yVel = 0;
+}
+
+void Dot::handle_input()
+{
+  if(event.type == SDL_KEYDOWN)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel -= DOT_VEL; break;
+      case SDLK_DOWN: yVel += DOT_VEL; break;
+      case SDLK_RIGHT: xVel += DOT_VEL; break;
+      case SDLK_LEFT: xVel -= DOT_VEL; break;
+    }
+  }
+  else if(event.type == SDL_KEYUP)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel += DOT_VEL; break;
+      case SDLK_DOWN: yVel -= DOT_VEL; break;
+      case SDLK_RIGHT: xVel -= DOT_VEL; break;
+      case SDLK_LEFT: xVel += DOT_VEL; break;
+    }
+  }
+}
+
+void Dot::move(float step)
+{
+  //Keep the old state to interpolate from
+  prevX = x;
+  prevY = y;
+
+  x += xVel * step;
+  if(x < 0)
+  {
+    x = 0;
+  }
+
+  if(x + DOT_WIDTH > SCREEN_WIDTH)
+  {
+    x = SCREEN_WIDTH - DOT_WIDTH;
+  }
+
+  y += yVel * step;
+  if(y < 0)
+  {
+    y = 0;
+  }
+
+  if(y + DOT_HEIGHT > SCREEN_HEIGHT)
+  {
+    y = SCREEN_HEIGHT - DOT_HEIGHT;
+  }
+}
+
+void Dot::show(float alpha)
+{
+  int showX = (int)(prevX + (x - prevX) * alpha + 0.5f);
+  int showY = (int)(prevY + (y - prevY) * alpha + 0.5f);
+
+  apply_surface(showX, showY, dot, screen);
+}
+
+int main(int argc, char* args[])
+{
+  bool quit = false;
+  bool cap = true;
+  int frame = 0;
+  int steps = 0;
+  Timer fps;
+  Timer update;
+  FixedTimestep timestep(TICKS_PER_SECOND);
+  Dot myDot;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  timestep.start();
+  update.start();
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    fps.start();
+
+    while(SDL_PollEvent(&event))
+    {
+      myDot.handle_input();
+
+      if(event.type == SDL_KEYDOWN)
+      {
+        if(event.key.keysym.sym == SDLK_RETURN)
+        {
+          cap = (!cap);
+        }
+        else if(event.key.keysym.sym == SDLK_SPACE)
+        {
+          //A hitch; the dot still covers the same distance
+          SDL_Delay(100);
+        }
+      }
+      else if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    //Simulate in fixed steps however long the frame took
+    for(int s = timestep.advance(); s > 0; s--)
+    {
+      myDot.move(timestep.get_step());
+      steps++;
+    }
+
+    SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+    myDot.show(timestep.get_alpha());
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    frame++;
+
+    if(update.get_ticks() > 1000)
+    {
+      std::stringstream caption;
+      caption << "Fixed Timestep - " << frame << " frames, " << steps << " steps per second";
+      SDL_WM_SetCaption(caption.str().c_str(), NULL);
+
+      frame = 0;
+      steps = 0;
+      update.start();
+    }
+
+    //Rendering can be capped or not without changing gameplay speed
+    if((cap == true) && (fps.get_ticks() < 1000 / FRAMES_PER_SECOND))
+    {
+      SDL_Delay((1000 / FRAMES_PER_SECOND) - fps.get_ticks());
+    }
+  }
+
+  clean_up();
+  return 0;
+}
@@ -0,0 +1,842 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include "SDL/SDL_ttf.h"
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <time.h>
+
+//Scrolling, particles and a text HUD held to a frame budget. Every frame the
+//FrameGovernor times each subsystem. When the work no longer fits in the
+//budget it turns down the optional subsystem that costs the most: particle
+//spawning, background chunk prefetch or HUD refresh. After a long enough
+//stretch of headroom it turns the cheapest one back up. Every decision is
+//appended to governor.log. L adds fake load to play a slower machine.
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 60;
+const int LEVEL_WIDTH = 1280;
+const int LEVEL_HEIGHT = 960;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+
+//The background is cut into chunks that are built on demand
+const int CHUNK_WIDTH = 160;
+const int CHUNK_HEIGHT = 120;
+const int CHUNKS_X = LEVEL_WIDTH / CHUNK_WIDTH;
+const int CHUNKS_Y = LEVEL_HEIGHT / CHUNK_HEIGHT;
+const int PREFETCH_PER_FRAME = 2;
+
+const int TOTAL_EMITTERS = 12;
+const int MAX_PARTICLES = 60;
+const int PARTICLE_LIFE = 10;
+
+//Subsystems timed each frame; all but the scene can be scaled
+const int SUBSYSTEM_SCENE = 0;
+const int SUBSYSTEM_PARTICLES = 1;
+const int SUBSYSTEM_PREFETCH = 2;
+const int SUBSYSTEM_HUD = 3;
+const int TOTAL_SUBSYSTEMS = 4;
+const char *SUBSYSTEM_NAMES[TOTAL_SUBSYSTEMS] = {"scene", "particles", "prefetch", "hud"};
+
+//Highest setting per subsystem: particles spawned per emitter per frame,
+//prefetch radius in chunks, HUD refresh step
+const int MAX_LEVELS[TOTAL_SUBSYSTEMS] = {0, 4, 2, 3};
+const int HUD_INTERVALS[4] = {30, 10, 3, 1};
+
+//Share of the frame the work may use, the rest is slack for the flip
+const float BUDGET_FRACTION = 0.8f;
+
+//Work below this share of the budget counts as headroom
+const float RESTORE_FRACTION = 0.6f;
+
+//Frames of headroom before turning anything back up
+const int CALM_FRAMES = 60;
+
+//Frames to wait after a change for the costs to settle
+const int COOLDOWN_FRAMES = 10;
+
+const int FAKE_LOAD_STEP = 4;
+const int MAX_FAKE_LOAD = 16;
+
+//Globals
+SDL_Surface *dot = NULL;
+SDL_Surface *shimmer = NULL;
+SDL_Surface *blue = NULL;
+SDL_Surface *green = NULL;
+SDL_Surface *red = NULL;
+SDL_Surface *background = NULL;
+SDL_Surface *hud = NULL;
+SDL_Surface *screen = NULL;
+SDL_Event event;
+TTF_Font *font = NULL;
+SDL_Color textColor = {0xFF, 0xFF, 0xFF};
+SDL_Rect camera = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+
+//Structs/Classes
+struct Particle
+{
+  int x, y;
+  int frame;
+  SDL_Surface *type;
+};
+
+class Emitter
+{
+  private:
+    int x, y;
+    int xVel, yVel;
+    Particle particles[MAX_PARTICLES];
+
+  public:
+    Emitter();
+    void move();
+    void spawn(int count);
+    void show();
+    void show_particles();
+};
+
+class Dot
+{
+  private:
+    int x, y;
+    int xVel, yVel;
+
+  public:
+    Dot();
+    void handle_input();
+    void move();
+    void show();
+    void set_camera();
+};
+
+class ChunkCache
+{
+  private:
+    SDL_Surface *chunks[CHUNKS_Y][CHUNKS_X];
+
+    bool build(int cx, int cy);
+
+  public:
+    ChunkCache();
+    ~ChunkCache();
+    void show();
+    void prefetch(int radius);
+    void evict(int radius);
+};
+
+class FrameGovernor
+{
+  private:
+    float budget;
+    float work;
+    float costs[TOTAL_SUBSYSTEMS];
+    float frameCosts[TOTAL_SUBSYSTEMS];
+    int levels[TOTAL_SUBSYSTEMS];
+    int cooldown;
+    int calm;
+    int frame;
+    std::ofstream telemetry;
+
+    void log(std::string action, int subsystem);
+
+  public:
+    FrameGovernor(int framesPerSecond, std::string logFile);
+    void record(int subsystem, float milliseconds);
+    void end_frame();
+    int get_level(int subsystem);
+    float get_work();
+    float get_budget();
+};
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *load_image(std::string filename);
+bool load_files();
+void clean_up();
+Sint64 now_nanoseconds();
+float milliseconds_since(Sint64 start);
+void fake_load(int milliseconds);
+
+//Functions
+int main(int argc, char* args[])
+{
+  bool quit = false;
+  int fakeLoad = 0;
+  int frame = 0;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  Dot myDot;
+  Emitter emitters[TOTAL_EMITTERS];
+  ChunkCache chunks;
+  FrameGovernor governor(FRAMES_PER_SECOND, "governor.log");
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    Sint64 frameStart = now_nanoseconds();
+
+    while(SDL_PollEvent(&event))
+    {
+      myDot.handle_input();
+
+      if(event.type == SDL_KEYDOWN)
+      {
+        if(event.key.keysym.sym == SDLK_l)
+        {
+          fakeLoad = (fakeLoad + FAKE_LOAD_STEP) % (MAX_FAKE_LOAD + FAKE_LOAD_STEP);
+        }
+      }
+      else if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    //Required work: what the camera sees
+    Sint64 start = now_nanoseconds();
+
+    myDot.move();
+    myDot.set_camera();
+    chunks.show();
+
+    for(int e = 0; e < TOTAL_EMITTERS; e++)
+    {
+      emitters[e].move();
+      emitters[e].show();
+    }
+
+    myDot.show();
+    fake_load(fakeLoad);
+
+    governor.record(SUBSYSTEM_SCENE, milliseconds_since(start));
+
+    //Optional work, each scaled by the governor
+    start = now_nanoseconds();
+
+    for(int e = 0; e < TOTAL_EMITTERS; e++)
+    {
+      emitters[e].spawn(governor.get_level(SUBSYSTEM_PARTICLES));
+      emitters[e].show_particles();
+    }
+
+    governor.record(SUBSYSTEM_PARTICLES, milliseconds_since(start));
+
+    start = now_nanoseconds();
+    chunks.prefetch(governor.get_level(SUBSYSTEM_PREFETCH));
+    chunks.evict(MAX_LEVELS[SUBSYSTEM_PREFETCH] + 1);
+    governor.record(SUBSYSTEM_PREFETCH, milliseconds_since(start));
+
+    start = now_nanoseconds();
+
+    if((hud == NULL) || (frame % HUD_INTERVALS[governor.get_level(SUBSYSTEM_HUD)] == 0))
+    {
+      std::stringstream text;
+      text.setf(std::ios::fixed);
+      text.precision(1);
+      text << "work " << governor.get_work() << "/" << governor.get_budget() << " ms";
+      text << "  particles " << governor.get_level(SUBSYSTEM_PARTICLES);
+      text << "  prefetch " << governor.get_level(SUBSYSTEM_PREFETCH);
+      text << "  hud 1/" << HUD_INTERVALS[governor.get_level(SUBSYSTEM_HUD)];
+      text << "  load " << fakeLoad << " ms";
+
+      SDL_FreeSurface(hud);
+      hud = TTF_RenderText_Solid(font, text.str().c_str(), textColor);
+    }
+
+    if(hud != NULL)
+    {
+      apply_surface(8, SCREEN_HEIGHT - hud->h - 8, hud, screen);
+    }
+
+    governor.record(SUBSYSTEM_HUD, milliseconds_since(start));
+    governor.end_frame();
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    frame++;
+
+    float frameTime = milliseconds_since(frameStart);
+
+    if(frameTime < 1000.f / FRAMES_PER_SECOND)
+    {
+      SDL_Delay((Uint32)(1000.f / FRAMES_PER_SECOND - frameTime));
+    }
+  }
+
+  clean_up();
+  return 0;
+}
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+float milliseconds_since(Sint64 start)
+{
+  return (now_nanoseconds() - start) / 1000000.0f;
+}
+
+void fake_load(int milliseconds)
+{
+  //Spin rather than sleep so it looks like real work
+  Sint64 end = now_nanoseconds() + (Sint64)milliseconds * 1000000;
+
+  while(now_nanoseconds() < end)
+  {
+  }
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  if(TTF_Init() == -1)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Frame Governor", NULL);
+
+  srand(SDL_GetTicks());
+
+  return true;
+}
+
+bool load_files()
+{
+  dot = load_image("dot.bmp");
+  background = load_image("bg.png");
+  font = TTF_OpenFont("lazy.ttf", 14);
+
+  if((dot == NULL) || (background == NULL) || (font == NULL))
+  {
+    return false;
+  }
+
+  red = load_image("red.bmp");
+  green = load_image("green.bmp");
+  blue = load_image("blue.bmp");
+  shimmer = load_image("shimmer.bmp");
+
+  if((shimmer == NULL) || (red == NULL) || (green == NULL) || (blue == NULL))
+  {
+    return false;
+  }
+
+  SDL_SetAlpha(red, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  SDL_SetAlpha(blue, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  SDL_SetAlpha(green, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  SDL_SetAlpha(shimmer, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+
+  return true;
+}
+
+void clean_up()
+{
+  SDL_FreeSurface(dot);
+  SDL_FreeSurface(background);
+  SDL_FreeSurface(hud);
+  SDL_FreeSurface(red);
+  SDL_FreeSurface(green);
+  SDL_FreeSurface(blue);
+  SDL_FreeSurface(shimmer);
+
+  TTF_CloseFont(font);
+
+  TTF_Quit();
+  SDL_Quit();
+}
+
+Emitter::Emitter()
+{
+  x = rand() % (LEVEL_WIDTH - DOT_WIDTH);
+  y = rand() % (LEVEL_HEIGHT - DOT_HEIGHT);
+  xVel = rand() % 9 - 4;
+  yVel = rand() % 9 - 4;
+
+  for(int p = 0; p < MAX_PARTICLES; p++)
+  {
+    particles[p].frame = PARTICLE_LIFE + 1;
+  }
+}
+
+void Emitter::move()
+{
+  x += xVel;
+
+  if((x < 0) || (x + DOT_WIDTH > LEVEL_WIDTH))
+  {
+    x -= xVel;
+    xVel = -xVel;
+  }
+
+  y += yVel;
+
+  if((y < 0) || (y + DOT_HEIGHT > LEVEL_HEIGHT))
+  {
+    y -= yVel;
+    yVel = -yVel;
+  }
+}
+
+void Emitter::spawn(int count)
+{
+  //Reuse dead slots; a full pool just spawns less
+  for(int p = 0; (p < MAX_PARTICLES) && (count > 0); p++)
+  {
+    if(particles[p].frame > PARTICLE_LIFE)
+    {
+      particles[p].x = x - 5 + (rand() % 25);
+      particles[p].y = y - 5 + (rand() % 25);
+      particles[p].frame = rand() % 5;
+
+      switch(rand() % 3)
+      {
+        case 0: particles[p].type = red; break;
+        case 1: particles[p].type = green; break;
+        case 2: particles[p].type = blue; break;
+      }
+
+      count--;
+    }
+  }
+}
+
+void Emitter::show()
+{
+  apply_surface(x - camera.x, y - camera.y, dot, screen);
+}
+
+void Emitter::show_particles()
+{
+  for(int p = 0; p < MAX_PARTICLES; p++)
+  {
+    if(particles[p].frame > PARTICLE_LIFE)
+    {
+      continue;
+    }
+
+    apply_surface(particles[p].x - camera.x, particles[p].y - camera.y, particles[p].type, screen);
+
+    if(particles[p].frame % 2 == 0)
+    {
+      apply_surface(particles[p].x - camera.x, particles[p].y - camera.y, shimmer, screen);
+    }
+
+    particles[p].frame++;
+  }
+}
+
+Dot::Dot()
+{
+  x = 0;
+  y = 0;
+  xVel = 0;
+  yVel = 0;
+}
+
+void Dot::handle_input()
+{
+  if(event.type == SDL_KEYDOWN)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel += DOT_WIDTH / 2; break;
+      case SDLK_LEFT: xVel -= DOT_WIDTH / 2; break;
+    }
+  }
+  else if(event.type == SDL_KEYUP)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel -= DOT_WIDTH / 2; break;
+      case SDLK_LEFT: xVel += DOT_WIDTH / 2; break;
+    }
+  }
+}
+
+void Dot::move()
+{
+  x += xVel;
+
+  if((x < 0) || (x + DOT_WIDTH > LEVEL_WIDTH))
+  {
+    x -= xVel;
+  }
+
+  y += yVel;
+
+  if((y < 0) || (y + DOT_HEIGHT > LEVEL_HEIGHT))
+  {
+    y -= yVel;
+  }
+}
+
+void Dot::show()
+{
+  apply_surface(x - camera.x, y - camera.y, dot, screen);
+}
+
+void Dot::set_camera()
+{
+  camera.x = (x + DOT_WIDTH / 2) - SCREEN_WIDTH / 2;
+  camera.y = (y + DOT_HEIGHT / 2) - SCREEN_HEIGHT / 2;
+
+  if(camera.x < 0)
+  {
+    camera.x = 0;
+  }
+  if(camera.y < 0)
+  {
+    camera.y = 0;
+  }
+  if(camera.x > LEVEL_WIDTH - camera.w)
+  {
+    camera.x = LEVEL_WIDTH - camera.w;
+  }
+  if(camera.y > LEVEL_HEIGHT - camera.h)
+  {
+    camera.y = LEVEL_HEIGHT - camera.h;
+  }
+}
+
+ChunkCache::ChunkCache()
+{
+  for(int cy = 0; cy < CHUNKS_Y; cy++)
+  {
+    for(int cx = 0; cx < CHUNKS_X; cx++)
+    {
+      chunks[cy][cx] = NULL;
+    }
+  }
+}
+
+ChunkCache::~ChunkCache()
+{
+  for(int cy = 0; cy < CHUNKS_Y; cy++)
+  {
+    for(int cx = 0; cx < CHUNKS_X; cx++)
+    {
+      SDL_FreeSurface(chunks[cy][cx]);
+    }
+  }
+}
+
+bool ChunkCache::build(int cx, int cy)
+{
+  if(chunks[cy][cx] != NULL)
+  {
+    return false;
+  }
+
+  //Stands in for decoding a chunk from disk
+  SDL_Surface *chunk = SDL_CreateRGBSurface(SDL_SWSURFACE, CHUNK_WIDTH, CHUNK_HEIGHT, SCREEN_BPP, 0, 0, 0, 0);
+
+  if(chunk == NULL)
+  {
+    return false;
+  }
+
+  SDL_Rect clip;
+  clip.x = cx * CHUNK_WIDTH;
+  clip.y = cy * CHUNK_HEIGHT;
+  clip.w = CHUNK_WIDTH;
+  clip.h = CHUNK_HEIGHT;
+
+  apply_surface(0, 0, background, chunk, &clip);
+
+  chunks[cy][cx] = SDL_DisplayFormat(chunk);
+  SDL_FreeSurface(chunk);
+
+  return chunks[cy][cx] != NULL;
+}
+
+void ChunkCache::show()
+{
+  int firstX = camera.x / CHUNK_WIDTH;
+  int firstY = camera.y / CHUNK_HEIGHT;
+  int lastX = (camera.x + camera.w - 1) / CHUNK_WIDTH;
+  int lastY = (camera.y + camera.h - 1) / CHUNK_HEIGHT;
+
+  for(int cy = firstY; cy <= lastY; cy++)
+  {
+    for(int cx = firstX; cx <= lastX; cx++)
+    {
+      //Whatever prefetch missed has to be built now, on the frame
+      build(cx, cy);
+
+      apply_surface(cx * CHUNK_WIDTH - camera.x, cy * CHUNK_HEIGHT - camera.y, chunks[cy][cx], screen);
+    }
+  }
+}
+
+void ChunkCache::prefetch(int radius)
+{
+  int firstX = camera.x / CHUNK_WIDTH - radius;
+  int firstY = camera.y / CHUNK_HEIGHT - radius;
+  int lastX = (camera.x + camera.w - 1) / CHUNK_WIDTH + radius;
+  int lastY = (camera.y + camera.h - 1) / CHUNK_HEIGHT + radius;
+  int loads = 0;
+
+  for(int cy = firstY; (cy <= lastY) && (loads < PREFETCH_PER_FRAME); cy++)
+  {
+    for(int cx = firstX; (cx <= lastX) && (loads < PREFETCH_PER_FRAME); cx++)
+    {
+      if((cx < 0) || (cy < 0) || (cx >= CHUNKS_X) || (cy >= CHUNKS_Y))
+      {
+        continue;
+      }
+
+      if(build(cx, cy) == true)
+      {
+        loads++;
+      }
+    }
+  }
+}
+
+void ChunkCache::evict(int radius)
+{
+  int firstX = camera.x / CHUNK_WIDTH - radius;
+  int firstY = camera.y / CHUNK_HEIGHT - radius;
+  int lastX = (camera.x + camera.w - 1) / CHUNK_WIDTH + radius;
+  int lastY = (camera.y + camera.h - 1) / CHUNK_HEIGHT + radius;
+
+  for(int cy = 0; cy < CHUNKS_Y; cy++)
+  {
+    for(int cx = 0; cx < CHUNKS_X; cx++)
+    {
+      if((cx < firstX) || (cx > lastX) || (cy < firstY) || (cy > lastY))
+      {
+        SDL_FreeSurface(chunks[cy][cx]);
+        chunks[cy][cx] = NULL;
+      }
+    }
+  }
+}
+
+FrameGovernor::FrameGovernor(int framesPerSecond, std::string logFile) : telemetry(logFile.c_str())
+{
+  budget = 1000.f / framesPerSecond * BUDGET_FRACTION;
+  work = 0;
+  cooldown = 0;
+  calm = 0;
+  frame = 0;
+
+  //Start at full quality and let the measurements decide
+  for(int s = 0; s < TOTAL_SUBSYSTEMS; s++)
+  {
+    costs[s] = 0;
+    frameCosts[s] = 0;
+    levels[s] = MAX_LEVELS[s];
+  }
+
+  telemetry << "ticks frame work budget action subsystem level";
+
+  for(int s = 0; s < TOTAL_SUBSYSTEMS; s++)
+  {
+    telemetry << " " << SUBSYSTEM_NAMES[s];
+  }
+
+  telemetry << "\n";
+}
+
+void FrameGovernor::record(int subsystem, float milliseconds)
+{
+  frameCosts[subsystem] += milliseconds;
+}
+
+void FrameGovernor::end_frame()
+{
+  float frameWork = 0;
+
+  //Smooth so one slow frame does not throw everything away
+  for(int s = 0; s < TOTAL_SUBSYSTEMS; s++)
+  {
+    costs[s] += (frameCosts[s] - costs[s]) * 0.1f;
+    frameWork += frameCosts[s];
+    frameCosts[s] = 0;
+  }
+
+  work += (frameWork - work) * 0.1f;
+  frame++;
+
+  if(cooldown > 0)
+  {
+    cooldown--;
+    return;
+  }
+
+  if(work > budget)
+  {
+    //Over budget: shed the most expensive optional work
+    int worst = -1;
+
+    for(int s = 0; s < TOTAL_SUBSYSTEMS; s++)
+    {
+      if((levels[s] > 0) && ((worst == -1) || (costs[s] > costs[worst])))
+      {
+        worst = s;
+      }
+    }
+
+    calm = 0;
+
+    if(worst != -1)
+    {
+      levels[worst]--;
+      log("shed", worst);
+      cooldown = COOLDOWN_FRAMES;
+    }
+  }
+  else if(work < budget * RESTORE_FRACTION)
+  {
+    calm++;
+
+    if(calm < CALM_FRAMES)
+    {
+      return;
+    }
+
+    //Plenty of room for a while: give back the cheapest work first
+    int cheapest = -1;
+
+    for(int s = 0; s < TOTAL_SUBSYSTEMS; s++)
+    {
+      if((levels[s] < MAX_LEVELS[s]) && ((cheapest == -1) || (costs[s] < costs[cheapest])))
+      {
+        cheapest = s;
+      }
+    }
+
+    calm = 0;
+
+    if(cheapest != -1)
+    {
+      levels[cheapest]++;
+      log("restore", cheapest);
+      cooldown = COOLDOWN_FRAMES;
+    }
+  }
+  else
+  {
+    calm = 0;
+  }
+}
+
+void FrameGovernor::log(std::string action, int subsystem)
+{
+  telemetry.setf(std::ios::fixed);
+  telemetry.precision(3);
+
+  telemetry << SDL_GetTicks() << " " << frame << " " << work << " " << budget << " ";
+  telemetry << action << " " << SUBSYSTEM_NAMES[subsystem] << " " << levels[subsystem];
+
+  for(int s = 0; s < TOTAL_SUBSYSTEMS; s++)
+  {
+    telemetry << " " << costs[s];
+  }
+
+  telemetry << std::endl;
+}
+
+int FrameGovernor::get_level(int subsystem)
+{
+  return levels[subsystem];
+}
+
+float FrameGovernor::get_work()
+{
+  return work;
+}
+
+float FrameGovernor::get_budget()
+{
+  return budget;
+}
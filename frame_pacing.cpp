@@ -0,0 +1,421 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <time.h>
+
+//Frame capping with a hybrid sleep/spin pacer. The pacer sleeps until
+//shortly before the frame deadline and spins on CLOCK_MONOTONIC for the
+//rest. How early it wakes is learned from how late its sleeps came back.
+//Return switches between the pacer and the old SDL_Delay cap; jitter for
+//both is printed on exit.
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 60;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+
+//Oversleep samples the spin margin is taken from
+const int OVERSLEEP_SAMPLES = 64;
+
+//Wake early by this percentile of them, so a few hiccups don't count
+const int OVERSLEEP_PERCENTILE = 95;
+
+//Extra margin on top of that
+const Sint64 MARGIN_SLACK = 100000;
+
+SDL_Surface *dot = NULL;
+SDL_Surface *screen = NULL;
+
+SDL_Event event;
+
+class FramePacer
+{
+  private:
+    Sint64 period;
+    Sint64 deadline;
+    Sint64 margin;
+    Sint64 oversleeps[OVERSLEEP_SAMPLES];
+    int nextSample;
+
+    void calibrate(Sint64 oversleep);
+
+  public:
+    FramePacer(int framesPerSecond);
+    void start();
+    void wait();
+    Sint64 get_margin();
+};
+
+class JitterStats
+{
+  private:
+    Sint64 target;
+    int count;
+    int missed;
+    double sum;
+    double sumSquares;
+    Sint64 worst;
+
+  public:
+    JitterStats(int framesPerSecond);
+    void record(Sint64 period);
+    void report(std::string name, std::ostream &out);
+};
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void sleep_nanoseconds(Sint64 nanoseconds)
+{
+  timespec length;
+  length.tv_sec = nanoseconds / 1000000000;
+  length.tv_nsec = nanoseconds % 1000000000;
+
+  nanosleep(&length, NULL);
+}
+
+FramePacer::FramePacer(int framesPerSecond)
+{
+  period = 1000000000 / framesPerSecond;
+  deadline = 0;
+  nextSample = 0;
+
+  //Start pessimistic, one scheduler tick, and let calibration tighten it
+  margin = 2000000;
+
+  for(int s = 0; s < OVERSLEEP_SAMPLES; s++)
+  {
+    oversleeps[s] = margin;
+  }
+}
+
+void FramePacer::start()
+{
+  deadline = now_nanoseconds() + period;
+}
+
+void FramePacer::wait()
+{
+  Sint64 now = now_nanoseconds();
+
+  //Sleep through most of what is left
+  if(deadline - now > margin)
+  {
+    Sint64 wanted = deadline - margin - now;
+    sleep_nanoseconds(wanted);
+
+    Sint64 woke = now_nanoseconds();
+    calibrate((woke - now) - wanted);
+  }
+  else
+  {
+    //A spin only frame measures nothing, but the margin still has to
+    //decay or one bad sleep could stop the pacer sleeping for good
+    calibrate(0);
+  }
+
+  //Spin the last stretch
+  while(now_nanoseconds() < deadline)
+  {
+  }
+
+  //Schedule from the deadline, not from now, so errors do not add up.
+  //If we are already a whole frame behind, start over instead of bursting.
+  deadline += period;
+
+  now = now_nanoseconds();
+
+  if(deadline < now)
+  {
+    deadline = now + period;
+  }
+}
+
+void FramePacer::calibrate(Sint64 oversleep)
+{
+  //Anything past half a frame is a hiccup, not scheduler latency
+  oversleep = std::max((Sint64)0, std::min(oversleep, period / 2));
+
+  oversleeps[nextSample] = oversleep;
+  nextSample = (nextSample + 1) % OVERSLEEP_SAMPLES;
+
+  //Wake early by a high percentile of recent oversleeps
+  Sint64 sorted[OVERSLEEP_SAMPLES];
+  std::copy(oversleeps, oversleeps + OVERSLEEP_SAMPLES, sorted);
+
+  int rank = (OVERSLEEP_SAMPLES - 1) * OVERSLEEP_PERCENTILE / 100;
+  std::nth_element(sorted, sorted + rank, sorted + OVERSLEEP_SAMPLES);
+
+  //Never so much that the pacer stops sleeping altogether
+  margin = std::min(sorted[rank] + MARGIN_SLACK, period / 2);
+}
+
+Sint64 FramePacer::get_margin()
+{
+  return margin;
+}
+
+JitterStats::JitterStats(int framesPerSecond)
+{
+  target = 1000000000 / framesPerSecond;
+  count = 0;
+  missed = 0;
+  sum = 0;
+  sumSquares = 0;
+  worst = 0;
+}
+
+void JitterStats::record(Sint64 period)
+{
+  Sint64 error = period - target;
+  double milliseconds = error / 1000000.0;
+
+  count++;
+  sum += milliseconds;
+  sumSquares += milliseconds * milliseconds;
+
+  if(error < 0)
+  {
+    error = -error;
+  }
+
+  if(error > worst)
+  {
+    worst = error;
+  }
+
+  //Half a frame late means the frame missed its slot
+  if(period - target > target / 2)
+  {
+    missed++;
+  }
+}
+
+void JitterStats::report(std::string name, std::ostream &out)
+{
+  if(count == 0)
+  {
+    out << name << ": no frames" << std::endl;
+    return;
+  }
+
+  double mean = sum / count;
+  double deviation = sqrt(sumSquares / count - mean * mean);
+
+  out << name << ": " << count << " frames";
+  out << ", mean error " << mean << " ms";
+  out << ", jitter (stddev) " << deviation << " ms";
+  out << ", worst " << worst / 1000000.0 << " ms";
+  out << ", missed " << missed << std::endl;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  //Return the optimized image
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  //Set up screen
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  //If there was an error setting up the screen
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Frame Pacing", NULL);
+
+  return true;
+}
+
+bool load_files()
+{
+  //Load image
+  dot = load_image("dot.bmp");
+
+  //If there was an error loading the images
+  if(dot == NULL)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  //Free the images
+  SDL_FreeSurface(dot);
+
+  SDL_Quit();
+}
+
+int main(int argc, char* args[])
+{
+  bool quit = false;
+  bool pace = true;
+  int x = 0;
+  int frame = 0;
+  Uint32 captionTicks = 0;
+  FramePacer pacer(FRAMES_PER_SECOND);
+  JitterStats pacedStats(FRAMES_PER_SECOND);
+  JitterStats delayStats(FRAMES_PER_SECOND);
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  pacer.start();
+  Sint64 frameStart = now_nanoseconds();
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    while(SDL_PollEvent(&event))
+    {
+      if(event.type == SDL_KEYDOWN)
+      {
+        if(event.key.keysym.sym == SDLK_RETURN)
+        {
+          pace = (!pace);
+          pacer.start();
+        }
+      }
+      else if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    //A steady sweep makes uneven frames easy to see
+    x = (x + 4) % SCREEN_WIDTH;
+
+    SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+    apply_surface(x, (SCREEN_HEIGHT - DOT_HEIGHT) / 2, dot, screen);
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    if(pace == true)
+    {
+      pacer.wait();
+    }
+    else
+    {
+      //The cap every other lesson uses
+      int ticks = (now_nanoseconds() - frameStart) / 1000000;
+
+      if(ticks < 1000 / FRAMES_PER_SECOND)
+      {
+        SDL_Delay((1000 / FRAMES_PER_SECOND) - ticks);
+      }
+    }
+
+    Sint64 frameEnd = now_nanoseconds();
+
+    if(pace == true)
+    {
+      pacedStats.record(frameEnd - frameStart);
+    }
+    else
+    {
+      delayStats.record(frameEnd - frameStart);
+    }
+
+    frameStart = frameEnd;
+    frame++;
+
+    if(SDL_GetTicks() - captionTicks > 1000)
+    {
+      std::stringstream caption;
+      caption << (pace ? "Sleep/spin pacer" : "SDL_Delay cap") << " - " << frame << " FPS";
+
+      if(pace == true)
+      {
+        caption << ", spin margin " << pacer.get_margin() / 1000000.0 << " ms";
+      }
+
+      SDL_WM_SetCaption(caption.str().c_str(), NULL);
+
+      frame = 0;
+      captionTicks = SDL_GetTicks();
+    }
+  }
+
+  pacedStats.report("Sleep/spin pacer", std::cout);
+  delayStats.report("SDL_Delay cap", std::cout);
+
+  clean_up();
+  return 0;
+}
@@ -0,0 +1,589 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <time.h>
+
+//Runs lesson scenes with no display, for timing rendering changes on
+//machines without X. SDL's dummy video driver gives SDL_SetVideoMode() a
+//plain memory surface of whatever size is asked for, so the drawing code is
+//unchanged. Every scene is driven by the frame number alone and renders
+//N frames back to back. Each frame's render time and framebuffer hash go
+//to headless_<scene>.csv. The summary gives percentiles and a hash over all
+//frames, which should only change when the picture does.
+//Usage: headless [scene|all] [frames] [width] [height] [window]
+
+//Constants
+//Screen size can be overridden from the command line
+int SCREEN_WIDTH = 640;
+int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+const int LEVEL_WIDTH = 1280;
+const int LEVEL_HEIGHT = 960;
+const int TILE_WIDTH = 80;
+const int TILE_HEIGHT = 80;
+const int TOTAL_TILES = 192;
+const int TILE_SPRITES = 12;
+const int TOTAL_PARTICLES = 20;
+const int RANDOM_SEED = 1;
+
+//Globals
+SDL_Surface *screen = NULL;
+SDL_Surface *background = NULL;
+SDL_Surface *dot = NULL;
+SDL_Surface *level = NULL;
+SDL_Surface *tileSheet = NULL;
+SDL_Surface *red = NULL;
+SDL_Surface *green = NULL;
+SDL_Surface *blue = NULL;
+SDL_Surface *shimmer = NULL;
+SDL_Rect camera = {0, 0, 0, 0};
+SDL_Rect clips[TILE_SPRITES];
+int tileTypes[TOTAL_TILES];
+
+//Structs/Classes
+struct Scene
+{
+  const char *name;
+  bool (*load)();
+  void (*render)(int frame);
+};
+
+struct Particle
+{
+  int x, y;
+  int frame;
+  SDL_Surface *type;
+};
+
+Particle particles[TOTAL_PARTICLES];
+
+//Prototypes
+bool init(bool window);
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *load_image(std::string filename);
+void clean_up();
+Sint64 now_nanoseconds();
+Uint32 hash_surface(SDL_Surface *surface);
+bool run_scene(Scene &scene, int frames);
+void sweep_camera(int frame);
+void dot_path(int frame, int &x, int &y);
+bool load_background();
+void render_background(int frame);
+bool load_particles();
+void render_particles(int frame);
+bool load_scrolling();
+void render_scrolling(int frame);
+bool load_tiling();
+void render_tiling(int frame);
+
+Scene scenes[] =
+{
+  {"background", load_background, render_background},
+  {"particles", load_particles, render_particles},
+  {"scrolling", load_scrolling, render_scrolling},
+  {"tiling", load_tiling, render_tiling}
+};
+
+const int TOTAL_SCENES = sizeof(scenes) / sizeof(scenes[0]);
+
+//Functions
+int main(int argc, char* args[])
+{
+  std::string only = "all";
+  int frames = 600;
+  bool window = false;
+
+  if(argc > 1)
+  {
+    only = args[1];
+  }
+
+  if(argc > 2)
+  {
+    frames = atoi(args[2]);
+  }
+
+  if(argc > 4)
+  {
+    SCREEN_WIDTH = atoi(args[3]);
+    SCREEN_HEIGHT = atoi(args[4]);
+  }
+
+  if((argc > 5) && (strcmp(args[5], "window") == 0))
+  {
+    window = true;
+  }
+
+  if((frames <= 0) || (SCREEN_WIDTH <= 0) || (SCREEN_HEIGHT <= 0))
+  {
+    std::cerr << "Usage: " << args[0] << " [scene|all] [frames] [width] [height] [window]" << std::endl;
+    return 1;
+  }
+
+  if(init(window) == false)
+  {
+    return 1;
+  }
+
+  int ran = 0;
+
+  for(int s = 0; s < TOTAL_SCENES; s++)
+  {
+    if((only != "all") && (only != scenes[s].name))
+    {
+      continue;
+    }
+
+    if(run_scene(scenes[s], frames) == false)
+    {
+      std::cerr << "Could not run " << scenes[s].name << std::endl;
+      clean_up();
+      return 1;
+    }
+
+    ran++;
+  }
+
+  if(ran == 0)
+  {
+    std::cerr << "No scene called " << only << std::endl;
+  }
+
+  clean_up();
+  return (ran == 0) ? 1 : 0;
+}
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+Uint32 hash_surface(SDL_Surface *surface)
+{
+  //FNV-1a over the visible bytes of each row, padding left out
+  Uint32 hash = 2166136261u;
+  int rowBytes = surface->w * surface->format->BytesPerPixel;
+
+  SDL_LockSurface(surface);
+
+  for(int y = 0; y < surface->h; y++)
+  {
+    Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+
+    for(int b = 0; b < rowBytes; b++)
+    {
+      hash ^= row[b];
+      hash *= 16777619u;
+    }
+  }
+
+  SDL_UnlockSurface(surface);
+
+  return hash;
+}
+
+bool run_scene(Scene &scene, int frames)
+{
+  if(scene.load() == false)
+  {
+    return false;
+  }
+
+  std::string filename = std::string("headless_") + scene.name + ".csv";
+  std::ofstream timings(filename.c_str());
+  timings << "frame,microseconds,hash\n";
+
+  std::vector<Sint64> times;
+  Uint32 combined = 2166136261u;
+
+  //Same pictures every run
+  srand(RANDOM_SEED);
+
+  for(int frame = 0; frame < frames; frame++)
+  {
+    Sint64 start = now_nanoseconds();
+
+    scene.render(frame);
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return false;
+    }
+
+    Sint64 length = now_nanoseconds() - start;
+    times.push_back(length);
+
+    //Hashing is not part of the frame
+    Uint32 hash = hash_surface(screen);
+    combined = (combined ^ hash) * 16777619u;
+
+    timings << frame << "," << length / 1000.0 << "," << std::hex << hash << std::dec << "\n";
+  }
+
+  std::sort(times.begin(), times.end());
+
+  Sint64 total = 0;
+
+  for(unsigned int t = 0; t < times.size(); t++)
+  {
+    total += times[t];
+  }
+
+  std::cout << scene.name << ": " << frames << " frames at " << SCREEN_WIDTH << "x" << SCREEN_HEIGHT;
+  std::cout << ", " << frames / (total / 1000000000.0) << " fps";
+  std::cout << ", ms avg " << total / frames / 1000000.0;
+  std::cout << " p50 " << times[frames / 2] / 1000000.0;
+  std::cout << " p95 " << times[(frames * 95) / 100] / 1000000.0;
+  std::cout << " p99 " << times[(frames * 99) / 100] / 1000000.0;
+  std::cout << " max " << times[frames - 1] / 1000000.0;
+  std::cout << ", hash " << std::hex << combined << std::dec << std::endl;
+
+  return true;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init(bool window)
+{
+  //No display needed unless asked for; keep a driver picked from outside
+  if((window == false) && (getenv("SDL_VIDEODRIVER") == NULL))
+  {
+    putenv((char *)"SDL_VIDEODRIVER=dummy");
+  }
+
+  //Video is all this needs
+  if(SDL_Init(SDL_INIT_VIDEO) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  camera.w = SCREEN_WIDTH;
+  camera.h = SCREEN_HEIGHT;
+
+  SDL_WM_SetCaption("Headless", NULL);
+
+  return true;
+}
+
+void clean_up()
+{
+  SDL_FreeSurface(background);
+  SDL_FreeSurface(dot);
+  SDL_FreeSurface(level);
+  SDL_FreeSurface(tileSheet);
+  SDL_FreeSurface(red);
+  SDL_FreeSurface(green);
+  SDL_FreeSurface(blue);
+  SDL_FreeSurface(shimmer);
+
+  SDL_Quit();
+}
+
+void sweep_camera(int frame)
+{
+  //Back and forth across the level, a pixel per frame horizontally
+  int rangeX = std::max(LEVEL_WIDTH - camera.w, 1);
+  int rangeY = std::max(LEVEL_HEIGHT - camera.h, 1);
+  int x = frame % (rangeX * 2);
+  int y = (frame / 2) % (rangeY * 2);
+
+  camera.x = (x < rangeX) ? x : rangeX * 2 - x;
+  camera.y = (y < rangeY) ? y : rangeY * 2 - y;
+
+  //Smaller levels than the screen just stay put
+  if(LEVEL_WIDTH <= camera.w)
+  {
+    camera.x = 0;
+  }
+
+  if(LEVEL_HEIGHT <= camera.h)
+  {
+    camera.y = 0;
+  }
+}
+
+void dot_path(int frame, int &x, int &y)
+{
+  //A slow circle around the middle of the screen
+  double angle = frame * 0.05;
+
+  x = (int)(SCREEN_WIDTH / 2 + cos(angle) * SCREEN_WIDTH / 3) - DOT_WIDTH / 2;
+  y = (int)(SCREEN_HEIGHT / 2 + sin(angle) * SCREEN_HEIGHT / 3) - DOT_HEIGHT / 2;
+}
+
+bool load_background()
+{
+  if(background == NULL)
+  {
+    background = load_image("background.png");
+  }
+
+  if(dot == NULL)
+  {
+    dot = load_image("dot.bmp");
+  }
+
+  return (background != NULL) && (dot != NULL);
+}
+
+void render_background(int frame)
+{
+  int x, y;
+  dot_path(frame, x, y);
+
+  //Tile the background over whatever size the screen is
+  for(int by = 0; by < SCREEN_HEIGHT; by += background->h)
+  {
+    for(int bx = 0; bx < SCREEN_WIDTH; bx += background->w)
+    {
+      apply_surface(bx, by, background, screen);
+    }
+  }
+
+  apply_surface(x, y, dot, screen);
+}
+
+bool load_particles()
+{
+  if(dot == NULL)
+  {
+    dot = load_image("dot.bmp");
+  }
+
+  if(red == NULL)
+  {
+    red = load_image("red.bmp");
+    green = load_image("green.bmp");
+    blue = load_image("blue.bmp");
+    shimmer = load_image("shimmer.bmp");
+
+    if((red == NULL) || (green == NULL) || (blue == NULL) || (shimmer == NULL))
+    {
+      return false;
+    }
+
+    SDL_SetAlpha(red, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+    SDL_SetAlpha(blue, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+    SDL_SetAlpha(green, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+    SDL_SetAlpha(shimmer, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  }
+
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    particles[p].frame = 11;
+  }
+
+  return dot != NULL;
+}
+
+void render_particles(int frame)
+{
+  int x, y;
+  dot_path(frame, x, y);
+
+  SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+  apply_surface(x, y, dot, screen);
+
+  //Same rules as the particle engine lesson
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    if(particles[p].frame > 10)
+    {
+      particles[p].x = x - 5 + (rand() % 25);
+      particles[p].y = y - 5 + (rand() % 25);
+      particles[p].frame = rand() % 5;
+
+      switch(rand() % 3)
+      {
+        case 0: particles[p].type = red; break;
+        case 1: particles[p].type = green; break;
+        case 2: particles[p].type = blue; break;
+      }
+    }
+
+    apply_surface(particles[p].x, particles[p].y, particles[p].type, screen);
+
+    if(particles[p].frame % 2 == 0)
+    {
+      apply_surface(particles[p].x, particles[p].y, shimmer, screen);
+    }
+
+    particles[p].frame++;
+  }
+}
+
+bool load_scrolling()
+{
+  if(level == NULL)
+  {
+    level = load_image("bg.png");
+  }
+
+  if(dot == NULL)
+  {
+    dot = load_image("dot.bmp");
+  }
+
+  return (level != NULL) && (dot != NULL);
+}
+
+void render_scrolling(int frame)
+{
+  int x, y;
+  dot_path(frame, x, y);
+  sweep_camera(frame);
+
+  //Outside the level stays black when the screen is bigger than it
+  SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0, 0, 0));
+
+  SDL_Rect view = camera;
+  apply_surface(0, 0, level, screen, &view);
+  apply_surface(x, y, dot, screen);
+}
+
+bool load_tiling()
+{
+  if(tileSheet == NULL)
+  {
+    tileSheet = load_image("tiles.png");
+  }
+
+  if(dot == NULL)
+  {
+    dot = load_image("dot.bmp");
+  }
+
+  if((tileSheet == NULL) || (dot == NULL))
+  {
+    return false;
+  }
+
+  //Sheet columns: plain colours, then left, middle and right edge pieces
+  const int sheetColumn[TILE_SPRITES] = {0, 0, 0, 2, 2, 3, 3, 3, 2, 1, 1, 1};
+  const int sheetRow[TILE_SPRITES] = {0, 1, 2, 1, 0, 0, 1, 2, 2, 2, 1, 0};
+
+  for(int t = 0; t < TILE_SPRITES; t++)
+  {
+    clips[t].x = sheetColumn[t] * TILE_WIDTH;
+    clips[t].y = sheetRow[t] * TILE_HEIGHT;
+    clips[t].w = TILE_WIDTH;
+    clips[t].h = TILE_HEIGHT;
+  }
+
+  std::ifstream map("lazy.map");
+
+  if(map == NULL)
+  {
+    return false;
+  }
+
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    int tileType = -1;
+    map >> tileType;
+
+    if((map.fail() == true) || (tileType < 0) || (tileType >= TILE_SPRITES))
+    {
+      return false;
+    }
+
+    tileTypes[t] = tileType;
+  }
+
+  return true;
+}
+
+void render_tiling(int frame)
+{
+  int x, y;
+  dot_path(frame, x, y);
+  sweep_camera(frame);
+
+  SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0, 0, 0));
+
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    int tileX = (t % (LEVEL_WIDTH / TILE_WIDTH)) * TILE_WIDTH;
+    int tileY = (t / (LEVEL_WIDTH / TILE_WIDTH)) * TILE_HEIGHT;
+
+    //Only what the camera sees
+    if((tileX + TILE_WIDTH <= camera.x) || (tileX >= camera.x + camera.w))
+    {
+      continue;
+    }
+
+    if((tileY + TILE_HEIGHT <= camera.y) || (tileY >= camera.y + camera.h))
+    {
+      continue;
+    }
+
+    apply_surface(tileX - camera.x, tileY - camera.y, tileSheet, screen, &clips[tileTypes[t]]);
+  }
+
+  apply_surface(x, y, dot, screen);
+}
@@ -1,10 +1,101 @@
 #include "SDL/SDL.h"
 #include <string>
+#include <algorithm>
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 const int SCREEN_BPP = 32;
 
+//How long the window stays up
+const int SHOW_TICKS = 2000;
+
+//The picture is static, so instead of sleeping blind the loop waits in
+//SDL_WaitEvent() and repaints whatever the window system says was lost
+class DirtyRect
+{
+  private:
+    SDL_Rect area;
+    bool dirty;
+
+  public:
+    DirtyRect();
+    void invalidate(SDL_Rect rect);
+    void invalidate_all();
+    bool is_dirty();
+    SDL_Rect get_area();
+    void clear();
+};
+
+DirtyRect::DirtyRect()
+{
+  dirty = false;
+  area.x = 0;
+  area.y = 0;
+  area.w = 0;
+  area.h = 0;
+}
+
+void DirtyRect::invalidate(SDL_Rect rect)
+{
+  //Keep it on the screen so it can go straight to SDL_UpdateRect()
+  int left = std::max((int)rect.x, 0);
+  int top = std::max((int)rect.y, 0);
+  int right = std::min(rect.x + rect.w, SCREEN_WIDTH);
+  int bottom = std::min(rect.y + rect.h, SCREEN_HEIGHT);
+
+  if((left >= right) || (top >= bottom))
+  {
+    return;
+  }
+
+  //Grow the area to cover both
+  if(dirty == true)
+  {
+    left = std::min(left, (int)area.x);
+    top = std::min(top, (int)area.y);
+    right = std::max(right, area.x + area.w);
+    bottom = std::max(bottom, area.y + area.h);
+  }
+
+  area.x = left;
+  area.y = top;
+  area.w = right - left;
+  area.h = bottom - top;
+  dirty = true;
+}
+
+void DirtyRect::invalidate_all()
+{
+  SDL_Rect all = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+  invalidate(all);
+}
+
+bool DirtyRect::is_dirty()
+{
+  return dirty;
+}
+
+SDL_Rect DirtyRect::get_area()
+{
+  return area;
+}
+
+void DirtyRect::clear()
+{
+  dirty = false;
+}
+
+Uint32 close_window(Uint32 interval, void *param)
+{
+  //Timers run on their own thread, so just post the quit to the main loop
+  SDL_Event quit;
+  quit.type = SDL_QUIT;
+
+  SDL_PushEvent(&quit);
+
+  return 0;
+}
+
 SDL_Surface *load_image(std::string filename)
 {
   //Temporary storage for the image that's loaded
@@ -48,7 +139,9 @@ int main(int argc, char* args[])
   SDL_Surface *screen = NULL;
   SDL_Surface *background = NULL;
   SDL_Surface *message= NULL;
-
+  SDL_Event event;
+  DirtyRect dirty;
+  bool quit = false;
 
   //Initialize all SDL subsystems
   if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
@@ -72,23 +165,53 @@ int main(int argc, char* args[])
   message = load_image("hello.bmp");
   background = load_image("background.bmp");
 
-  //Apply the background to the screen
-  apply_surface(320, 0, background, screen);
-  apply_surface(0, 240, background, screen);
-  apply_surface(0, 0, background, screen);
-  apply_surface(320, 240, background, screen);
+  //Wait without spinning, the timer ends it
+  SDL_AddTimer(SHOW_TICKS, close_window, NULL);
 
-  //Apply the message to the screen
-  apply_surface(180, 140, message, screen);
+  //Everything needs drawing the first time
+  dirty.invalidate_all();
 
-  if(SDL_Flip(screen) == -1)
+  while(quit == false)
   {
-    return 1;
+    if(dirty.is_dirty() == true)
+    {
+      SDL_Rect area = dirty.get_area();
+      SDL_SetClipRect(screen, &area);
+
+      //Apply the background to the screen
+      apply_surface(320, 0, background, screen);
+      apply_surface(0, 240, background, screen);
+      apply_surface(0, 0, background, screen);
+      apply_surface(320, 240, background, screen);
+
+      //Apply the message to the screen
+      apply_surface(180, 140, message, screen);
+
+      SDL_SetClipRect(screen, NULL);
+      SDL_UpdateRect(screen, area.x, area.y, area.w, area.h);
+
+      dirty.clear();
+    }
+
+    if(SDL_WaitEvent(&event) == 0)
+    {
+      return 1;
+    }
+
+    if(event.type == SDL_QUIT)
+    {
+      quit = true;
+    }
+    else if(event.type == SDL_VIDEOEXPOSE)
+    {
+      dirty.invalidate_all();
+    }
+    else if((event.type == SDL_ACTIVEEVENT) && (event.active.gain == 1))
+    {
+      dirty.invalidate_all();
+    }
   }
 
-  //Wait
-  SDL_Delay(2000);
-
   //Free the surfaces
   SDL_FreeSurface(message);
   SDL_FreeSurface(background);
@@ -0,0 +1,544 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include "SDL/SDL_ttf.h"
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <time.h>
+
+//The frame rate lesson with an in-window performance overlay instead of an
+//average in the caption. The overlay keeps the last FRAME_HISTORY frame
+//times, graphs them, shows min/avg/max/p95/p99 over that window and a bar per
+//subsystem. Text comes from a glyph atlas rendered once at startup, so the
+//overlay is a handful of fills and small blits. H hides it.
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 60;
+
+const int FRAME_HISTORY = 120;
+const int HUD_X = 8;
+const int HUD_Y = 8;
+const int HUD_WIDTH = FRAME_HISTORY * 2 + 8;
+const int GRAPH_HEIGHT = 50;
+
+//Milliseconds the graph and bars show at full height/width
+const float GRAPH_RANGE = 33.3f;
+
+const int FIRST_GLYPH = 32;
+const int LAST_GLYPH = 126;
+
+//Subsystems timed every frame
+const int SUBSYSTEM_EVENTS = 0;
+const int SUBSYSTEM_RENDER = 1;
+const int SUBSYSTEM_HUD = 2;
+const int SUBSYSTEM_FLIP = 3;
+const int TOTAL_SUBSYSTEMS = 4;
+const char *SUBSYSTEM_NAMES[TOTAL_SUBSYSTEMS] = {"events", "render", "hud", "flip"};
+
+SDL_Surface *background = NULL;
+SDL_Surface *screen = NULL;
+
+SDL_Event event;
+TTF_Font *font = NULL;
+SDL_Color hudColor = {0xFF, 0xFF, 0xFF};
+
+class GlyphAtlas
+{
+  private:
+    SDL_Surface *glyphs;
+    SDL_Rect clips[LAST_GLYPH + 1];
+    int lineHeight;
+
+  public:
+    GlyphAtlas();
+    ~GlyphAtlas();
+    bool build(TTF_Font *ttf, SDL_Color color);
+    void show_text(int x, int y, std::string text, SDL_Surface *destination);
+    int get_line_height();
+};
+
+class FrameStats
+{
+  private:
+    float frameTimes[FRAME_HISTORY];
+    int next;
+    int count;
+    float subsystemTimes[TOTAL_SUBSYSTEMS];
+
+  public:
+    FrameStats();
+    void record_frame(float milliseconds);
+    void record_subsystem(int subsystem, float milliseconds);
+    float get_frame(int age);
+    float get_subsystem(int subsystem);
+    int get_count();
+    void summary(float &minimum, float &average, float &maximum, float &p95, float &p99);
+};
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+float milliseconds_since(Sint64 start)
+{
+  return (now_nanoseconds() - start) / 1000000.0f;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  //Return the optimized image
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  //Set up screen
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  //If there was an error setting up the screen
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  if(TTF_Init() == -1)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Performance HUD", NULL);
+
+  return true;
+}
+
+bool load_files()
+{
+  //Load image
+  background = load_image("background.png");
+
+  //Small font for the overlay
+  font = TTF_OpenFont("lazy.ttf", 12);
+
+  //If there was an error loading the images
+  if(background == NULL)
+  {
+    return false;
+  }
+
+  if(font == NULL)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  //Free the images
+  SDL_FreeSurface(background);
+
+  TTF_CloseFont(font);
+
+  TTF_Quit();
+  SDL_Quit();
+}
+
+GlyphAtlas::GlyphAtlas()
+{
+  glyphs = NULL;
+  lineHeight = 0;
+
+  for(int c = 0; c <= LAST_GLYPH; c++)
+  {
+    clips[c].x = 0;
+    clips[c].y = 0;
+    clips[c].w = 0;
+    clips[c].h = 0;
+  }
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+  SDL_FreeSurface(glyphs);
+}
+
+bool GlyphAtlas::build(TTF_Font *ttf, SDL_Color color)
+{
+  SDL_Surface *rendered[LAST_GLYPH + 1];
+  int width = 0;
+
+  //Render every printable character once
+  for(int c = FIRST_GLYPH; c <= LAST_GLYPH; c++)
+  {
+    char text[2] = {(char)c, '\0'};
+    rendered[c] = TTF_RenderText_Solid(ttf, text, color);
+
+    if(rendered[c] == NULL)
+    {
+      for(int f = FIRST_GLYPH; f < c; f++)
+      {
+        SDL_FreeSurface(rendered[f]);
+      }
+
+      return false;
+    }
+
+    width += rendered[c]->w;
+    lineHeight = std::max(lineHeight, rendered[c]->h);
+  }
+
+  //One row, in the display format, colour keyed like every other image
+  SDL_Surface *row = SDL_CreateRGBSurface(SDL_SWSURFACE, width, lineHeight, SCREEN_BPP, 0, 0, 0, 0);
+
+  if(row != NULL)
+  {
+    glyphs = SDL_DisplayFormat(row);
+    SDL_FreeSurface(row);
+  }
+
+  if(glyphs != NULL)
+  {
+    Uint32 colorkey = SDL_MapRGB(glyphs->format, 0, 0xFF, 0xFF);
+    SDL_FillRect(glyphs, &glyphs->clip_rect, colorkey);
+    SDL_SetColorKey(glyphs, SDL_SRCCOLORKEY | SDL_RLEACCEL, colorkey);
+  }
+
+  int x = 0;
+
+  for(int c = FIRST_GLYPH; c <= LAST_GLYPH; c++)
+  {
+    clips[c].x = x;
+    clips[c].y = 0;
+    clips[c].w = rendered[c]->w;
+    clips[c].h = rendered[c]->h;
+
+    if(glyphs != NULL)
+    {
+      apply_surface(x, 0, rendered[c], glyphs);
+    }
+
+    x += rendered[c]->w;
+    SDL_FreeSurface(rendered[c]);
+  }
+
+  return glyphs != NULL;
+}
+
+void GlyphAtlas::show_text(int x, int y, std::string text, SDL_Surface *destination)
+{
+  for(unsigned int c = 0; c < text.size(); c++)
+  {
+    int glyph = (unsigned char)text[c];
+
+    if((glyph < FIRST_GLYPH) || (glyph > LAST_GLYPH))
+    {
+      glyph = '?';
+    }
+
+    apply_surface(x, y, glyphs, destination, &clips[glyph]);
+    x += clips[glyph].w;
+  }
+}
+
+int GlyphAtlas::get_line_height()
+{
+  return lineHeight;
+}
+
+FrameStats::FrameStats()
+{
+  next = 0;
+  count = 0;
+
+  for(int f = 0; f < FRAME_HISTORY; f++)
+  {
+    frameTimes[f] = 0;
+  }
+
+  for(int s = 0; s < TOTAL_SUBSYSTEMS; s++)
+  {
+    subsystemTimes[s] = 0;
+  }
+}
+
+void FrameStats::record_frame(float milliseconds)
+{
+  frameTimes[next] = milliseconds;
+  next = (next + 1) % FRAME_HISTORY;
+
+  if(count < FRAME_HISTORY)
+  {
+    count++;
+  }
+}
+
+void FrameStats::record_subsystem(int subsystem, float milliseconds)
+{
+  //Smoothed a little so the bars are readable
+  subsystemTimes[subsystem] += (milliseconds - subsystemTimes[subsystem]) * 0.1f;
+}
+
+float FrameStats::get_frame(int age)
+{
+  //Age 0 is the newest frame
+  return frameTimes[(next - 1 - age + FRAME_HISTORY) % FRAME_HISTORY];
+}
+
+float FrameStats::get_subsystem(int subsystem)
+{
+  return subsystemTimes[subsystem];
+}
+
+int FrameStats::get_count()
+{
+  return count;
+}
+
+void FrameStats::summary(float &minimum, float &average, float &maximum, float &p95, float &p99)
+{
+  float sorted[FRAME_HISTORY];
+  float total = 0;
+
+  for(int f = 0; f < count; f++)
+  {
+    sorted[f] = get_frame(f);
+    total += sorted[f];
+  }
+
+  std::sort(sorted, sorted + count);
+
+  minimum = sorted[0];
+  maximum = sorted[count - 1];
+  average = total / count;
+  p95 = sorted[(count * 95) / 100];
+  p99 = sorted[(count * 99) / 100];
+}
+
+void show_hud(FrameStats &stats, GlyphAtlas &text)
+{
+  if(stats.get_count() == 0)
+  {
+    return;
+  }
+
+  int lineHeight = text.get_line_height();
+  int graphY = HUD_Y + 4 + lineHeight * 2;
+  int barsY = graphY + GRAPH_HEIGHT + 4;
+
+  SDL_Rect panel;
+  panel.x = HUD_X;
+  panel.y = HUD_Y;
+  panel.w = HUD_WIDTH;
+  panel.h = (barsY - HUD_Y) + lineHeight * TOTAL_SUBSYSTEMS + 4;
+  SDL_FillRect(screen, &panel, SDL_MapRGB(screen->format, 0x20, 0x20, 0x20));
+
+  float minimum, average, maximum, p95, p99;
+  stats.summary(minimum, average, maximum, p95, p99);
+
+  std::stringstream line;
+  line.setf(std::ios::fixed);
+  line.precision(1);
+  line << "ms  min " << minimum << "  avg " << average << "  max " << maximum;
+  text.show_text(HUD_X + 4, HUD_Y + 2, line.str(), screen);
+
+  line.str("");
+  line << "p95 " << p95 << "  p99 " << p99 << "  fps " << 1000.f / average;
+  text.show_text(HUD_X + 4, HUD_Y + 2 + lineHeight, line.str(), screen);
+
+  //Frame time graph, newest on the right, red past the frame budget
+  float budget = 1000.f / FRAMES_PER_SECOND;
+  Uint32 good = SDL_MapRGB(screen->format, 0x40, 0xC0, 0x40);
+  Uint32 bad = SDL_MapRGB(screen->format, 0xE0, 0x40, 0x40);
+
+  for(int f = 0; f < stats.get_count(); f++)
+  {
+    float frameTime = stats.get_frame(f);
+    int height = (int)(frameTime / GRAPH_RANGE * GRAPH_HEIGHT);
+
+    if(height > GRAPH_HEIGHT)
+    {
+      height = GRAPH_HEIGHT;
+    }
+
+    SDL_Rect bar;
+    bar.x = HUD_X + 4 + (FRAME_HISTORY - 1 - f) * 2;
+    bar.y = graphY + GRAPH_HEIGHT - height;
+    bar.w = 2;
+    bar.h = height;
+    SDL_FillRect(screen, &bar, (frameTime > budget) ? bad : good);
+  }
+
+  SDL_Rect budgetLine;
+  budgetLine.x = HUD_X + 4;
+  budgetLine.y = graphY + GRAPH_HEIGHT - (int)(budget / GRAPH_RANGE * GRAPH_HEIGHT);
+  budgetLine.w = FRAME_HISTORY * 2;
+  budgetLine.h = 1;
+  SDL_FillRect(screen, &budgetLine, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+
+  //One bar per subsystem
+  for(int s = 0; s < TOTAL_SUBSYSTEMS; s++)
+  {
+    int y = barsY + s * lineHeight;
+    float subsystemTime = stats.get_subsystem(s);
+
+    line.str("");
+    line.precision(2);
+    line << SUBSYSTEM_NAMES[s] << " " << subsystemTime;
+    text.show_text(HUD_X + 4, y, line.str(), screen);
+
+    SDL_Rect bar;
+    bar.x = HUD_X + 100;
+    bar.y = y + 2;
+    bar.w = (int)(subsystemTime / GRAPH_RANGE * (HUD_WIDTH - 104));
+    bar.h = lineHeight - 4;
+
+    if(bar.w > HUD_WIDTH - 104)
+    {
+      bar.w = HUD_WIDTH - 104;
+    }
+
+    SDL_FillRect(screen, &bar, good);
+  }
+}
+
+int main(int argc, char* args[])
+{
+  bool quit = false;
+  bool hud = true;
+  FrameStats stats;
+  GlyphAtlas text;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  if(text.build(font, hudColor) == false)
+  {
+    return 1;
+  }
+
+  Sint64 frameStart = now_nanoseconds();
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    Sint64 start = now_nanoseconds();
+
+    while(SDL_PollEvent(&event))
+    {
+      if(event.type == SDL_KEYDOWN)
+      {
+        if(event.key.keysym.sym == SDLK_h)
+        {
+          hud = (!hud);
+        }
+      }
+      else if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    stats.record_subsystem(SUBSYSTEM_EVENTS, milliseconds_since(start));
+
+    start = now_nanoseconds();
+    apply_surface(0, 0, background, screen);
+    stats.record_subsystem(SUBSYSTEM_RENDER, milliseconds_since(start));
+
+    start = now_nanoseconds();
+
+    if(hud == true)
+    {
+      show_hud(stats, text);
+    }
+
+    stats.record_subsystem(SUBSYSTEM_HUD, milliseconds_since(start));
+
+    start = now_nanoseconds();
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    stats.record_subsystem(SUBSYSTEM_FLIP, milliseconds_since(start));
+
+    //Frame to frame, so the cap below counts too
+    float frameTime = milliseconds_since(frameStart);
+
+    if(frameTime < 1000.f / FRAMES_PER_SECOND)
+    {
+      SDL_Delay((Uint32)(1000.f / FRAMES_PER_SECOND - frameTime));
+    }
+
+    Sint64 frameEnd = now_nanoseconds();
+    stats.record_frame((frameEnd - frameStart) / 1000000.0f);
+    frameStart = frameEnd;
+  }
+
+  clean_up();
+  return 0;
+}
@@ -0,0 +1,398 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//load_image that keeps a copy of every image already converted to the display
+//format next to the source ("dot.png" -> "dot.png.dfc"). A valid cache entry
+//is read straight into a new surface, skipping the PNG decode and the
+//SDL_DisplayFormat conversion.
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const Uint32 CACHE_MAGIC = 0x43464444;
+const Uint32 CACHE_VERSION = 1;
+const int HASH_CHUNK = 65536;
+
+//Structs/Classes
+struct CacheHeader
+{
+  Uint32 magic;
+  Uint32 version;
+
+  //What the cache was built from
+  Uint64 sourceMtime;
+  Uint64 sourceSize;
+  Uint64 sourceHash;
+
+  //The surface that follows the header
+  Uint32 w, h;
+  Uint32 pitch;
+  Uint32 bitsPerPixel;
+  Uint32 Rmask, Gmask, Bmask, Amask;
+  Uint32 flags;
+  Uint32 colorkey;
+};
+
+//Globals
+SDL_Surface *background = NULL;
+SDL_Surface *dot = NULL;
+SDL_Surface *tiles = NULL;
+SDL_Surface *foo = NULL;
+SDL_Surface *screen = NULL;
+SDL_Event event;
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *load_image(std::string filename);
+SDL_Surface *decode_image(std::string filename);
+SDL_Surface *read_cache(std::string cacheName, struct stat &source, std::string filename);
+bool write_cache(std::string cacheName, struct stat &source, Uint64 hash, SDL_Surface *surface);
+bool hash_file(std::string filename, Uint64 &hash);
+bool load_files();
+void clean_up();
+
+//Functions
+int main(int argc, char* args[])
+{
+  bool quit = false;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  Uint32 loadStart = SDL_GetTicks();
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  std::stringstream caption;
+  caption << "Image Cache - loaded in " << SDL_GetTicks() - loadStart << " ms";
+  SDL_WM_SetCaption(caption.str().c_str(), NULL);
+
+  apply_surface(0, 0, background, screen);
+  apply_surface(0, 0, tiles, screen);
+  apply_surface(SCREEN_WIDTH - foo->w, SCREEN_HEIGHT - foo->h, foo, screen);
+  apply_surface((SCREEN_WIDTH - dot->w) / 2, (SCREEN_HEIGHT - dot->h) / 2, dot, screen);
+
+  if(SDL_Flip(screen) == -1)
+  {
+    return 1;
+  }
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    while(SDL_PollEvent(&event))
+    {
+      if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+  }
+
+  clean_up();
+  return 0;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  std::string cacheName = filename + ".dfc";
+  struct stat source;
+
+  if(stat(filename.c_str(), &source) == -1)
+  {
+    return NULL;
+  }
+
+  //Try the converted copy first
+  SDL_Surface *optimizedImage = read_cache(cacheName, source, filename);
+
+  if(optimizedImage != NULL)
+  {
+    return optimizedImage;
+  }
+
+  //Stale or missing, decode the slow way and refresh the cache
+  optimizedImage = decode_image(filename);
+
+  Uint64 hash = 0;
+
+  if((optimizedImage != NULL) && (hash_file(filename, hash) == true))
+  {
+    write_cache(cacheName, source, hash, optimizedImage);
+  }
+
+  return optimizedImage;
+}
+
+SDL_Surface *decode_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+SDL_Surface *read_cache(std::string cacheName, struct stat &source, std::string filename)
+{
+  CacheHeader header;
+  SDL_PixelFormat *display = screen->format;
+
+  int file = open(cacheName.c_str(), O_RDONLY);
+
+  if(file == -1)
+  {
+    return NULL;
+  }
+
+  if(read(file, &header, sizeof(header)) != (ssize_t)sizeof(header))
+  {
+    close(file);
+    return NULL;
+  }
+
+  //The pixels are only useful if they are still in the display format
+  if((header.magic != CACHE_MAGIC) || (header.version != CACHE_VERSION) ||
+     (header.bitsPerPixel != display->BitsPerPixel) ||
+     (header.Rmask != display->Rmask) || (header.Gmask != display->Gmask) ||
+     (header.Bmask != display->Bmask) || (header.Amask != display->Amask) ||
+     (header.sourceSize != (Uint64)source.st_size))
+  {
+    close(file);
+    return NULL;
+  }
+
+  //A touched but unchanged source only costs a hash, not a decode
+  if(header.sourceMtime != (Uint64)source.st_mtime)
+  {
+    Uint64 hash = 0;
+
+    if((hash_file(filename, hash) == false) || (hash != header.sourceHash))
+    {
+      close(file);
+      return NULL;
+    }
+  }
+
+  SDL_Surface *surface = SDL_CreateRGBSurface(SDL_SWSURFACE, header.w, header.h, header.bitsPerPixel,
+                                              header.Rmask, header.Gmask, header.Bmask, header.Amask);
+
+  if(surface == NULL)
+  {
+    close(file);
+    return NULL;
+  }
+
+  ssize_t size = (ssize_t)header.pitch * header.h;
+  bool loaded = false;
+
+  //Same pitch means one read straight into the pixels
+  if(surface->pitch == header.pitch)
+  {
+    loaded = (read(file, surface->pixels, size) == size);
+  }
+
+  close(file);
+
+  if(loaded == false)
+  {
+    SDL_FreeSurface(surface);
+    return NULL;
+  }
+
+  if(header.flags & SDL_SRCCOLORKEY)
+  {
+    SDL_SetColorKey(surface, SDL_SRCCOLORKEY, header.colorkey);
+  }
+
+  return surface;
+}
+
+bool write_cache(std::string cacheName, struct stat &source, Uint64 hash, SDL_Surface *surface)
+{
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+
+  header.magic = CACHE_MAGIC;
+  header.version = CACHE_VERSION;
+  header.sourceMtime = source.st_mtime;
+  header.sourceSize = source.st_size;
+  header.sourceHash = hash;
+  header.w = surface->w;
+  header.h = surface->h;
+  header.pitch = surface->pitch;
+  header.bitsPerPixel = surface->format->BitsPerPixel;
+  header.Rmask = surface->format->Rmask;
+  header.Gmask = surface->format->Gmask;
+  header.Bmask = surface->format->Bmask;
+  header.Amask = surface->format->Amask;
+  header.flags = surface->flags & SDL_SRCCOLORKEY;
+  header.colorkey = surface->format->colorkey;
+
+  //Write to a temporary name so a crash never leaves half a cache behind
+  std::string tempName = cacheName + ".tmp";
+  int file = open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  if(file == -1)
+  {
+    return false;
+  }
+
+  ssize_t size = (ssize_t)surface->pitch * surface->h;
+  bool written = (write(file, &header, sizeof(header)) == (ssize_t)sizeof(header));
+
+  if(written == true)
+  {
+    if(SDL_MUSTLOCK(surface))
+    {
+      SDL_LockSurface(surface);
+    }
+
+    written = (write(file, surface->pixels, size) == size);
+
+    if(SDL_MUSTLOCK(surface))
+    {
+      SDL_UnlockSurface(surface);
+    }
+  }
+
+  close(file);
+
+  if((written == false) || (rename(tempName.c_str(), cacheName.c_str()) == -1))
+  {
+    unlink(tempName.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool hash_file(std::string filename, Uint64 &hash)
+{
+  //64 bit FNV-1a
+  static unsigned char buffer[HASH_CHUNK];
+
+  int file = open(filename.c_str(), O_RDONLY);
+
+  if(file == -1)
+  {
+    return false;
+  }
+
+  hash = 14695981039346656037ULL;
+
+  ssize_t got = 0;
+
+  while((got = read(file, buffer, HASH_CHUNK)) > 0)
+  {
+    for(ssize_t b = 0; b < got; b++)
+    {
+      hash ^= buffer[b];
+      hash *= 1099511628211ULL;
+    }
+  }
+
+  close(file);
+
+  return got == 0;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Image Cache", NULL);
+
+  return true;
+}
+
+bool load_files()
+{
+  background = load_image("background.png");
+  dot = load_image("dot.png");
+  tiles = load_image("tiles.png");
+  foo = load_image("foo.png");
+
+  if((background == NULL) || (dot == NULL) || (tiles == NULL) || (foo == NULL))
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  SDL_FreeSurface(background);
+  SDL_FreeSurface(dot);
+  SDL_FreeSurface(tiles);
+  SDL_FreeSurface(foo);
+
+  SDL_Quit();
+}
@@ -0,0 +1,951 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+
+//The particle engine with its input stream recorded or played back.
+//Recording logs every input event SDL_PollEvent() hands the loop, stamped
+//with the frame it arrived in, plus the rand() seed. Replay pushes the
+//events back into SDL's queue at the start of the same frame, so they reach
+//handle_input() the way live input would. Live keyboard and mouse input is
+//ignored while replaying. A checksum of the dot's path is stored at the end
+//of the log and checked after replay.
+//Usage: input_replay [record|replay|fast] [file]
+//fast replays without the frame cap, for profiling.
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 20;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+const int TOTAL_PARTICLES = 20;
+
+//Log format
+const char LOG_MAGIC[4] = {'S', 'D', 'L', 'R'};
+const Uint8 LOG_VERSION = 1;
+
+//Record types; anything else SDL delivers is not input and is left out
+const Uint8 RECORD_KEYDOWN = 1;
+const Uint8 RECORD_KEYUP = 2;
+const Uint8 RECORD_MOTION = 3;
+const Uint8 RECORD_BUTTONDOWN = 4;
+const Uint8 RECORD_BUTTONUP = 5;
+const Uint8 RECORD_ACTIVE = 6;
+const Uint8 RECORD_QUIT = 7;
+const Uint8 RECORD_END = 0xFF;
+
+enum Mode
+{
+  MODE_PLAY,
+  MODE_RECORD,
+  MODE_REPLAY,
+  MODE_FAST
+};
+
+//Globals
+SDL_Surface *dot = NULL;
+SDL_Surface *shimmer = NULL;
+SDL_Surface *blue = NULL;
+SDL_Surface *green = NULL;
+SDL_Surface *red = NULL;
+SDL_Surface *screen = NULL;
+SDL_Event event;
+
+//Structs/Classes
+class Particle
+{
+  private:
+    int x, y;
+    int frame;
+
+    SDL_Surface *type;
+
+  public:
+    Particle(int X, int Y);
+    void show();
+    bool is_dead();
+};
+
+class Dot
+{
+  private:
+    int x, y;
+    int xVel, yVel;
+    Particle *particles[TOTAL_PARTICLES];
+
+  public:
+    Dot();
+    ~Dot();
+    void handle_input();
+    void move();
+    void show();
+    void show_particles();
+    int get_x();
+    int get_y();
+};
+
+class Timer
+{
+  private:
+    int startTicks;
+    int pausedTicks;
+
+    bool paused;
+    bool started;
+
+  public:
+    Timer();
+    void start();
+    void stop();
+    void pause();
+    void unpause();
+    int get_ticks();
+    bool is_started();
+    bool is_paused();
+};
+
+//Writes the log as it goes: a header, then for every event the frames
+//since the last one as a varint, a type byte and only the fields that
+//type uses
+class InputRecorder
+{
+  private:
+    std::ofstream file;
+    Uint32 lastFrame;
+
+    void put8(Uint8 value);
+    void put16(Uint16 value);
+    void put32(Uint32 value);
+    void put_varint(Uint32 value);
+    void put_stamp(Uint32 frame, Uint8 type);
+
+  public:
+    InputRecorder();
+    bool open(std::string filename, Uint32 seed);
+    void record(Uint32 frame, SDL_Event &e);
+    void close(Uint32 frames, Uint32 checksum);
+};
+
+//Reads the whole log up front and hands out each frame's events
+class InputReplayer
+{
+  private:
+    std::vector<Uint8> data;
+    unsigned int at;
+    Uint32 nextFrame;
+    Uint8 nextType;
+    Uint32 seed;
+    Uint32 totalFrames;
+    Uint32 checksum;
+
+    Uint8 get8();
+    Uint16 get16();
+    Uint32 get32();
+    Uint32 get_varint();
+    void read_stamp();
+
+  public:
+    InputReplayer();
+    bool open(std::string filename);
+    void feed(Uint32 frame);
+    bool is_finished(Uint32 frame);
+    Uint32 get_seed();
+    Uint32 get_checksum();
+};
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *load_image(std::string filename);
+bool load_files();
+void clean_up();
+Uint32 fold_checksum(Uint32 checksum, int value);
+
+//Functions
+int main(int argc, char* args[])
+{
+  Mode mode = MODE_PLAY;
+  std::string filename = "session.rec";
+  InputRecorder recorder;
+  InputReplayer replayer;
+  Timer fps;
+  Timer run;
+  bool quit = false;
+
+  if(argc > 1)
+  {
+    std::string name = args[1];
+
+    if(name == "record")
+    {
+      mode = MODE_RECORD;
+    }
+    else if(name == "replay")
+    {
+      mode = MODE_REPLAY;
+    }
+    else if(name == "fast")
+    {
+      mode = MODE_FAST;
+    }
+  }
+
+  if(argc > 2)
+  {
+    filename = args[2];
+  }
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  Uint32 seed = SDL_GetTicks();
+
+  if(mode == MODE_RECORD)
+  {
+    if(recorder.open(filename, seed) == false)
+    {
+      return 1;
+    }
+  }
+  else if((mode == MODE_REPLAY) || (mode == MODE_FAST))
+  {
+    if(replayer.open(filename) == false)
+    {
+      std::cerr << "Could not read " << filename << std::endl;
+      return 1;
+    }
+
+    seed = replayer.get_seed();
+
+    //Only the log drives the dot; pushed events are not filtered by this
+    SDL_EventState(SDL_KEYDOWN, SDL_IGNORE);
+    SDL_EventState(SDL_KEYUP, SDL_IGNORE);
+    SDL_EventState(SDL_MOUSEMOTION, SDL_IGNORE);
+    SDL_EventState(SDL_MOUSEBUTTONDOWN, SDL_IGNORE);
+    SDL_EventState(SDL_MOUSEBUTTONUP, SDL_IGNORE);
+    SDL_EventState(SDL_ACTIVEEVENT, SDL_IGNORE);
+  }
+
+  srand(seed);
+
+  //Built after seeding, its particles use rand()
+  Dot myDot;
+
+  Uint32 frame = 0;
+  Uint32 checksum = 2166136261u;
+
+  run.start();
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    fps.start();
+
+    if((mode == MODE_REPLAY) || (mode == MODE_FAST))
+    {
+      if(replayer.is_finished(frame) == true)
+      {
+        break;
+      }
+
+      replayer.feed(frame);
+    }
+
+    while(SDL_PollEvent(&event))
+    {
+      if(mode == MODE_RECORD)
+      {
+        recorder.record(frame, event);
+      }
+
+      myDot.handle_input();
+
+      if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    myDot.move();
+    checksum = fold_checksum(checksum, myDot.get_x());
+    checksum = fold_checksum(checksum, myDot.get_y());
+
+    SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+    myDot.show();
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    frame++;
+
+    //Fast replay runs flat out
+    if((mode != MODE_FAST) && (fps.get_ticks() < 1000 / FRAMES_PER_SECOND))
+    {
+      SDL_Delay((1000 / FRAMES_PER_SECOND) - fps.get_ticks());
+    }
+  }
+
+  int ticks = run.get_ticks();
+
+  if(mode == MODE_RECORD)
+  {
+    recorder.close(frame, checksum);
+    std::cout << "Recorded " << frame << " frames to " << filename << std::endl;
+  }
+  else if((mode == MODE_REPLAY) || (mode == MODE_FAST))
+  {
+    std::cout << "Replayed " << frame << " frames in " << ticks << " ms";
+
+    if(ticks > 0)
+    {
+      std::cout << " (" << frame * 1000.0 / ticks << " fps)";
+    }
+
+    std::cout << std::endl;
+
+    if(checksum != replayer.get_checksum())
+    {
+      std::cout << "Replay diverged from the recording" << std::endl;
+    }
+  }
+
+  clean_up();
+  return 0;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_VIDEO) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Input Replay", NULL);
+
+  return true;
+}
+
+bool load_files()
+{
+  dot = load_image("dot.bmp");
+
+  if(dot == NULL)
+  {
+    return false;
+  }
+
+  red = load_image("red.bmp");
+  green = load_image("green.bmp");
+  blue = load_image("blue.bmp");
+  shimmer = load_image("shimmer.bmp");
+
+  if((shimmer == NULL) || (red == NULL) || (green == NULL) || (blue == NULL))
+  {
+    return false;
+  }
+
+  SDL_SetAlpha(red, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  SDL_SetAlpha(blue, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  SDL_SetAlpha(green, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  SDL_SetAlpha(shimmer, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+
+  return true;
+}
+
+void clean_up()
+{
+  SDL_FreeSurface(dot);
+  SDL_FreeSurface(red);
+  SDL_FreeSurface(green);
+  SDL_FreeSurface(blue);
+  SDL_FreeSurface(shimmer);
+
+  SDL_Quit();
+}
+
+Uint32 fold_checksum(Uint32 checksum, int value)
+{
+  //FNV-1a, one byte at a time
+  for(int b = 0; b < 4; b++)
+  {
+    checksum ^= (value >> (b * 8)) & 0xFF;
+    checksum *= 16777619u;
+  }
+
+  return checksum;
+}
+
+InputRecorder::InputRecorder()
+{
+  lastFrame = 0;
+}
+
+void InputRecorder::put8(Uint8 value)
+{
+  file.put((char)value);
+}
+
+void InputRecorder::put16(Uint16 value)
+{
+  //Little endian whatever the machine is
+  put8(value & 0xFF);
+  put8(value >> 8);
+}
+
+void InputRecorder::put32(Uint32 value)
+{
+  put16(value & 0xFFFF);
+  put16(value >> 16);
+}
+
+void InputRecorder::put_varint(Uint32 value)
+{
+  //Seven bits a byte, high bit set while more follow
+  while(value >= 0x80)
+  {
+    put8((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+
+  put8(value);
+}
+
+void InputRecorder::put_stamp(Uint32 frame, Uint8 type)
+{
+  //Most events land a few frames apart, so this is usually one byte
+  put_varint(frame - lastFrame);
+  put8(type);
+  lastFrame = frame;
+}
+
+bool InputRecorder::open(std::string filename, Uint32 seed)
+{
+  file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+  if(file.is_open() == false)
+  {
+    return false;
+  }
+
+  file.write(LOG_MAGIC, 4);
+  put8(LOG_VERSION);
+  put32(seed);
+
+  lastFrame = 0;
+
+  return true;
+}
+
+void InputRecorder::record(Uint32 frame, SDL_Event &e)
+{
+  if(file.is_open() == false)
+  {
+    return;
+  }
+
+  switch(e.type)
+  {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+      put_stamp(frame, (e.type == SDL_KEYDOWN) ? RECORD_KEYDOWN : RECORD_KEYUP);
+      put16(e.key.keysym.sym);
+      put16(e.key.keysym.mod);
+      put16(e.key.keysym.unicode);
+      put8(e.key.keysym.scancode);
+      break;
+
+    case SDL_MOUSEMOTION:
+      put_stamp(frame, RECORD_MOTION);
+      put8(e.motion.state);
+      put16(e.motion.x);
+      put16(e.motion.y);
+      put16(e.motion.xrel);
+      put16(e.motion.yrel);
+      break;
+
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+      put_stamp(frame, (e.type == SDL_MOUSEBUTTONDOWN) ? RECORD_BUTTONDOWN : RECORD_BUTTONUP);
+      put8(e.button.button);
+      put16(e.button.x);
+      put16(e.button.y);
+      break;
+
+    case SDL_ACTIVEEVENT:
+      put_stamp(frame, RECORD_ACTIVE);
+      put8(e.active.gain);
+      put8(e.active.state);
+      break;
+
+    case SDL_QUIT:
+      put_stamp(frame, RECORD_QUIT);
+      break;
+  }
+}
+
+void InputRecorder::close(Uint32 frames, Uint32 checksum)
+{
+  if(file.is_open() == false)
+  {
+    return;
+  }
+
+  //Replay runs until this frame, then compares its own checksum
+  put_stamp(frames, RECORD_END);
+  put32(checksum);
+
+  file.close();
+}
+
+InputReplayer::InputReplayer()
+{
+  at = 0;
+  nextFrame = 0;
+  nextType = RECORD_END;
+  seed = 0;
+  totalFrames = 0;
+  checksum = 0;
+}
+
+Uint8 InputReplayer::get8()
+{
+  //A cut off log reads as zeros and ends at the next stamp
+  if(at >= data.size())
+  {
+    return 0;
+  }
+
+  return data[at++];
+}
+
+Uint16 InputReplayer::get16()
+{
+  Uint16 low = get8();
+  Uint16 high = get8();
+
+  return low | (high << 8);
+}
+
+Uint32 InputReplayer::get32()
+{
+  Uint32 low = get16();
+  Uint32 high = get16();
+
+  return low | (high << 16);
+}
+
+Uint32 InputReplayer::get_varint()
+{
+  Uint32 value = 0;
+  int shift = 0;
+  Uint8 byte = 0;
+
+  do
+  {
+    byte = get8();
+    value |= (Uint32)(byte & 0x7F) << shift;
+    shift += 7;
+  }
+  while(((byte & 0x80) != 0) && (shift < 35));
+
+  return value;
+}
+
+void InputReplayer::read_stamp()
+{
+  if(at >= data.size())
+  {
+    //No end record; stop after the last event
+    totalFrames = nextFrame + 1;
+    nextType = RECORD_END;
+    return;
+  }
+
+  nextFrame += get_varint();
+  nextType = get8();
+
+  if(nextType == RECORD_END)
+  {
+    totalFrames = nextFrame;
+    checksum = get32();
+  }
+}
+
+bool InputReplayer::open(std::string filename)
+{
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+
+  if(file == NULL)
+  {
+    return false;
+  }
+
+  std::stringstream contents;
+  contents << file.rdbuf();
+  std::string bytes = contents.str();
+
+  data.assign(bytes.begin(), bytes.end());
+  at = 0;
+
+  if((data.size() < 9) || (bytes.compare(0, 4, LOG_MAGIC, 4) != 0))
+  {
+    return false;
+  }
+
+  at = 4;
+
+  if(get8() != LOG_VERSION)
+  {
+    return false;
+  }
+
+  seed = get32();
+  nextFrame = 0;
+  read_stamp();
+
+  return true;
+}
+
+void InputReplayer::feed(Uint32 frame)
+{
+  while((nextType != RECORD_END) && (nextFrame == frame))
+  {
+    SDL_Event e;
+    memset(&e, 0, sizeof(e));
+
+    switch(nextType)
+    {
+      case RECORD_KEYDOWN:
+      case RECORD_KEYUP:
+        e.type = (nextType == RECORD_KEYDOWN) ? SDL_KEYDOWN : SDL_KEYUP;
+        e.key.state = (nextType == RECORD_KEYDOWN) ? SDL_PRESSED : SDL_RELEASED;
+        e.key.keysym.sym = (SDLKey)get16();
+        e.key.keysym.mod = (SDLMod)get16();
+        e.key.keysym.unicode = get16();
+        e.key.keysym.scancode = get8();
+        break;
+
+      case RECORD_MOTION:
+        e.type = SDL_MOUSEMOTION;
+        e.motion.state = get8();
+        e.motion.x = get16();
+        e.motion.y = get16();
+        e.motion.xrel = (Sint16)get16();
+        e.motion.yrel = (Sint16)get16();
+        break;
+
+      case RECORD_BUTTONDOWN:
+      case RECORD_BUTTONUP:
+        e.type = (nextType == RECORD_BUTTONDOWN) ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+        e.button.state = (nextType == RECORD_BUTTONDOWN) ? SDL_PRESSED : SDL_RELEASED;
+        e.button.button = get8();
+        e.button.x = get16();
+        e.button.y = get16();
+        break;
+
+      case RECORD_ACTIVE:
+        e.type = SDL_ACTIVEEVENT;
+        e.active.gain = get8();
+        e.active.state = get8();
+        break;
+
+      case RECORD_QUIT:
+        e.type = SDL_QUIT;
+        break;
+
+      default:
+        //Unknown type, its size is unknown too, so nothing after it can be trusted
+        totalFrames = frame + 1;
+        nextType = RECORD_END;
+        return;
+    }
+
+    SDL_PushEvent(&e);
+    read_stamp();
+  }
+}
+
+bool InputReplayer::is_finished(Uint32 frame)
+{
+  return (nextType == RECORD_END) && (frame >= totalFrames);
+}
+
+Uint32 InputReplayer::get_seed()
+{
+  return seed;
+}
+
+Uint32 InputReplayer::get_checksum()
+{
+  return checksum;
+}
+
+Timer::Timer()
+{
+  startTicks = 0;
+  pausedTicks = 0;
+  paused = false;
+  started = false;
+}
+
+void Timer::start()
+{
+  started = true;
+  paused = false;
+  startTicks = SDL_GetTicks();
+}
+
+void Timer::stop()
+{
+  started = false;
+  paused = false;
+}
+
+int Timer::get_ticks()
+{
+  if(started == true)
+  {
+    if(paused == true)
+    {
+      return pausedTicks;
+    }
+    else
+    {
+      return SDL_GetTicks() - startTicks;
+    }
+  }
+  return 0;
+}
+
+void Timer::pause()
+{
+  if((started == true) && (paused == false))
+  {
+    paused = true;
+    pausedTicks = SDL_GetTicks() - startTicks;
+  }
+}
+
+void Timer::unpause()
+{
+  if(paused == true)
+  {
+    paused = false;
+    startTicks = SDL_GetTicks() - pausedTicks;
+    pausedTicks = 0;
+  }
+}
+
+bool Timer::is_started()
+{
+  return started;
+}
+
+bool Timer::is_paused()
+{
+  return paused;
+}
+
+void Dot::handle_input()
+{
+  if(event.type == SDL_KEYDOWN)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel += DOT_WIDTH / 2; break;
+      case SDLK_LEFT: xVel -= DOT_WIDTH / 2; break;
+    }
+  }
+  else if(event.type == SDL_KEYUP)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel -= DOT_WIDTH / 2; break;
+      case SDLK_LEFT: xVel += DOT_WIDTH / 2; break;
+    }
+  }
+}
+
+Dot::Dot()
+{
+  x = 0;
+  y = 0;
+  xVel = 0;
+  yVel = 0;
+
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    particles[p] = new Particle(x, y);
+  }
+}
+
+Dot::~Dot()
+{
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    delete particles[p];
+  }
+}
+
+void Dot::move()
+{
+  x += xVel;
+
+  if((x < 0) || (x + DOT_WIDTH > SCREEN_WIDTH))
+  {
+    x -= xVel;
+  }
+
+  y += yVel;
+
+  if((y < 0) || (y + DOT_HEIGHT > SCREEN_HEIGHT))
+  {
+    y -= yVel;
+  }
+}
+
+void Dot::show()
+{
+  apply_surface(x, y, dot, screen);
+  show_particles();
+}
+
+void Dot::show_particles()
+{
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    if(particles[p]->is_dead() == true)
+    {
+      delete particles[p];
+      particles[p] = new Particle(x, y);
+    }
+  }
+
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    particles[p]->show();
+  }
+}
+
+int Dot::get_x()
+{
+  return x;
+}
+
+int Dot::get_y()
+{
+  return y;
+}
+
+Particle::Particle(int X, int Y)
+{
+  x = X - 5 + (rand() % 25);
+  y = Y - 5 + (rand() % 25);
+
+  frame = rand() % 5;
+
+  switch(rand() % 3)
+  {
+    case 0: type = red; break;
+    case 1: type = green; break;
+    case 2: type = blue; break;
+  }
+}
+
+void Particle::show()
+{
+  apply_surface(x, y, type, screen);
+
+  if(frame % 2 == 0)
+  {
+    apply_surface(x, y, shimmer, screen);
+  }
+
+  frame++;
+}
+
+bool Particle::is_dead()
+{
+  if(frame > 10)
+  {
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,469 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include "SDL/SDL_ttf.h"
+#include "SDL/SDL_mixer.h"
+#include <string>
+#include <vector>
+#include <time.h>
+
+//The sounds lesson without SDL_Init(SDL_INIT_EVERYTHING). A SubsystemManager
+//brings each piece up the first time something needs it: video and TTF for
+//the first frame, audio and the mixer only when a key first asks for a
+//sound. Every step goes on a timeline; the startup part prints after the
+//first frame, the whole thing on exit.
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+
+SDL_Surface *background = NULL;
+SDL_Surface *screen = NULL;
+SDL_Surface *message = NULL;
+
+SDL_Event event;
+TTF_Font *font = NULL;
+SDL_Color textColor = {0, 0, 0};
+
+Mix_Music *music = NULL;
+
+Mix_Chunk *scratch = NULL;
+Mix_Chunk *high = NULL;
+Mix_Chunk *med = NULL;
+Mix_Chunk *low = NULL;
+
+struct TimelineStep
+{
+  std::string name;
+  Sint64 start;
+  Sint64 length;
+};
+
+class SubsystemManager
+{
+  private:
+    Sint64 origin;
+    bool ttfReady;
+    bool audioReady;
+    std::vector<TimelineStep> timeline;
+
+  public:
+    SubsystemManager();
+    Sint64 begin();
+    void end(std::string name, Sint64 start);
+    bool require(Uint32 flags, std::string name);
+    bool require_ttf();
+    bool require_audio();
+    void report(std::ostream &out);
+    void shut_down();
+};
+
+SubsystemManager subsystems;
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+SubsystemManager::SubsystemManager()
+{
+  origin = now_nanoseconds();
+  ttfReady = false;
+  audioReady = false;
+}
+
+Sint64 SubsystemManager::begin()
+{
+  return now_nanoseconds();
+}
+
+void SubsystemManager::end(std::string name, Sint64 start)
+{
+  TimelineStep step;
+  step.name = name;
+  step.start = start - origin;
+  step.length = now_nanoseconds() - start;
+
+  timeline.push_back(step);
+}
+
+bool SubsystemManager::require(Uint32 flags, std::string name)
+{
+  //Already up, nothing to pay
+  if(SDL_WasInit(flags) == flags)
+  {
+    return true;
+  }
+
+  Sint64 start = begin();
+
+  if(SDL_InitSubSystem(flags) == -1)
+  {
+    return false;
+  }
+
+  end(name, start);
+
+  return true;
+}
+
+bool SubsystemManager::require_ttf()
+{
+  if(ttfReady == true)
+  {
+    return true;
+  }
+
+  Sint64 start = begin();
+
+  if(TTF_Init() == -1)
+  {
+    return false;
+  }
+
+  end("TTF_Init", start);
+  ttfReady = true;
+
+  return true;
+}
+
+bool SubsystemManager::require_audio()
+{
+  if(audioReady == true)
+  {
+    return true;
+  }
+
+  if(require(SDL_INIT_AUDIO, "audio subsystem") == false)
+  {
+    return false;
+  }
+
+  Sint64 start = begin();
+
+  if(Mix_OpenAudio(22050, MIX_DEFAULT_FORMAT, 2, 4096) == -1)
+  {
+    return false;
+  }
+
+  end("Mix_OpenAudio", start);
+  audioReady = true;
+
+  return true;
+}
+
+void SubsystemManager::report(std::ostream &out)
+{
+  out << "Init timeline (ms since launch)" << std::endl;
+
+  for(unsigned int s = 0; s < timeline.size(); s++)
+  {
+    out << "  " << timeline[s].start / 1000000.0 << "\t+" << timeline[s].length / 1000000.0;
+    out << "\t" << timeline[s].name << std::endl;
+  }
+}
+
+void SubsystemManager::shut_down()
+{
+  if(audioReady == true)
+  {
+    Mix_CloseAudio();
+  }
+
+  if(ttfReady == true)
+  {
+    TTF_Quit();
+  }
+
+  //Takes down whichever subsystems were started
+  SDL_Quit();
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  //Return the optimized image
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Only what the first frame needs
+  if(subsystems.require(SDL_INIT_VIDEO, "video subsystem") == false)
+  {
+    return false;
+  }
+
+  Sint64 start = subsystems.begin();
+
+  //Set up screen
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  //If there was an error setting up the screen
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Lazy Init", NULL);
+
+  subsystems.end("SDL_SetVideoMode", start);
+
+  if(subsystems.require_ttf() == false)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+bool load_files()
+{
+  Sint64 start = subsystems.begin();
+
+  //Load image
+  background = load_image("background.png");
+
+  //If there was an error loading the images
+  if(background == NULL)
+  {
+    return false;
+  }
+
+  subsystems.end("background.png", start);
+
+  start = subsystems.begin();
+
+  //Open the font
+  font = TTF_OpenFont("lazy.ttf", 30);
+
+  if(font == NULL)
+  {
+    return false;
+  }
+
+  subsystems.end("lazy.ttf", start);
+
+  return true;
+}
+
+bool load_sounds()
+{
+  //First sound request: bring audio up, then load what it plays
+  if(subsystems.require_audio() == false)
+  {
+    return false;
+  }
+
+  if(music != NULL)
+  {
+    return true;
+  }
+
+  Sint64 start = subsystems.begin();
+
+  music = Mix_LoadMUS("beat.wav");
+
+  if(music == NULL)
+  {
+    return false;
+  }
+
+  scratch = Mix_LoadWAV("scratch.wav");
+  high = Mix_LoadWAV("high.wav");
+  med = Mix_LoadWAV("medium.wav");
+  low = Mix_LoadWAV("low.wav");
+
+  if((scratch == NULL) || (high == NULL) || (med == NULL) || (low == NULL))
+  {
+    return false;
+  }
+
+  subsystems.end("sounds", start);
+
+  return true;
+}
+
+void clean_up()
+{
+  //Free the surfaces
+  SDL_FreeSurface(background);
+
+  //Free the sound effects
+  Mix_FreeChunk(scratch);
+  Mix_FreeChunk(high);
+  Mix_FreeChunk(med);
+  Mix_FreeChunk(low);
+
+  //Free the music
+  Mix_FreeMusic(music);
+
+  TTF_CloseFont(font);
+
+  subsystems.shut_down();
+}
+
+int main(int argc, char* args[])
+{
+  bool quit = false;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  Sint64 start = subsystems.begin();
+
+  apply_surface(0, 0, background, screen);
+
+  const char *lines[3] = {"1, 2, 3, or 4 to play a sound effect", "Press 9 to play or pause the music", "Press 0 to stop the music"};
+
+  for(int l = 0; l < 3; l++)
+  {
+    message = TTF_RenderText_Solid(font, lines[l], textColor);
+
+    if(message == NULL)
+    {
+      return 1;
+    }
+
+    apply_surface((SCREEN_WIDTH - message->w) / 2, 100 * (l + 1), message, screen);
+    SDL_FreeSurface(message);
+  }
+
+  if(SDL_Flip(screen) == -1)
+  {
+    return 1;
+  }
+
+  subsystems.end("first frame", start);
+  subsystems.report(std::cout);
+
+  //While the user hasn't quit
+  while(quit == false)
+  {
+    //While there's events to handle
+    while(SDL_PollEvent(&event))
+    {
+      //If a key was pressed
+      if(event.type == SDL_KEYDOWN)
+      {
+        SDLKey key = event.key.keysym.sym;
+
+        if((key == SDLK_1) || (key == SDLK_2) || (key == SDLK_3) || (key == SDLK_4) || (key == SDLK_9))
+        {
+          if(load_sounds() == false)
+          {
+            return 1;
+          }
+        }
+
+        Mix_Chunk *effect = NULL;
+
+        switch(key)
+        {
+          case SDLK_1: effect = scratch; break;
+          case SDLK_2: effect = high; break;
+          case SDLK_3: effect = med; break;
+          case SDLK_4: effect = low; break;
+        }
+
+        if(effect != NULL)
+        {
+          if(Mix_PlayChannel(-1, effect, 0) == -1)
+          {
+            return 1;
+          }
+        }
+        else if(key == SDLK_9)
+        {
+          //If there is no music playing
+          if(Mix_PlayingMusic() == 0)
+          {
+            if(Mix_PlayMusic(music, -1) == -1)
+            {
+              return 1;
+            }
+          }
+          else if(Mix_PausedMusic() == 1)
+          {
+            Mix_ResumeMusic();
+          }
+          else
+          {
+            Mix_PauseMusic();
+          }
+        }
+        else if(key == SDLK_0)
+        {
+          //Nothing to stop if audio never started
+          if(music != NULL)
+          {
+            Mix_HaltMusic();
+          }
+        }
+      }
+
+      //If the user has Xed out the window
+      if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+  }
+
+  subsystems.report(std::cout);
+
+  clean_up();
+  return 0;
+}
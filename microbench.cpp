@@ -0,0 +1,1145 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <sched.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#else
+#define HAVE_RDTSC 0
+#endif
+
+//Microbenchmarks for the primitives the lessons lean on every frame. The
+//original versions are copied in unchanged, with alternatives next to them
+//in the same group, and each group prints relative to its first entry.
+//The process is pinned to one CPU. Each benchmark warms up, then runs
+//REPETITIONS times over a fixed, seeded input set: random rects and circles
+//in screen space, the dot's collision boxes, and clips from the real sprite
+//sheets. The report gives median and spread of cycles per item. Cycles are
+//TSC ticks on x86 and nanoseconds elsewhere.
+//Usage: microbench [filter] [repetitions] [cpu]
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+const int TILE_WIDTH = 80;
+const int TILE_HEIGHT = 80;
+const int RANDOM_SEED = 1;
+
+//Sized so one run takes well over a timer tick but stays in cache
+const int TOTAL_ITEMS = 4096;
+const int TOTAL_BLITS = 256;
+const int TOTAL_WALLS = 8;
+
+const int DEFAULT_REPETITIONS = 31;
+const int WARMUP_RUNS = 3;
+const int WARMUP_NANOSECONDS = 100000000;
+
+//Globals
+SDL_Surface *screen = NULL;
+SDL_Surface *canvas = NULL;
+SDL_Surface *fontSheet = NULL;
+SDL_Surface *tileSheet = NULL;
+SDL_Surface *tileSheetRle = NULL;
+SDL_Surface *dot = NULL;
+
+//Keeps results alive so the compiler can't drop the work
+volatile Uint32 sink = 0;
+
+//Structs/Classes
+struct Circle
+{
+  int x, y;
+  int r;
+};
+
+class BitmapFont
+{
+  private:
+    SDL_Surface *bitmap;
+    SDL_Rect chars[256];
+    int newLine, space;
+
+  public:
+    BitmapFont();
+    void build_font(SDL_Surface *surface);
+    int get_width(int ascii);
+};
+
+class Dot
+{
+  private:
+    int x, y;
+    std::vector<SDL_Rect> box;
+    int offsetX[11];
+    int offsetY[11];
+
+  public:
+    Dot();
+    void set_position(int X, int Y);
+    void shift_boxes();
+    void shift_boxes_offsets();
+    std::vector<SDL_Rect> &get_rects();
+};
+
+struct Benchmark
+{
+  const char *group;
+  const char *name;
+  Uint32 (*run)();
+  int items;
+  bool (*available)();
+};
+
+struct BenchmarkResult
+{
+  double median;
+  double spread;
+  double best;
+};
+
+//Inputs, all built from RANDOM_SEED
+std::vector<SDL_Rect> rectsA;
+std::vector<SDL_Rect> rectsB;
+std::vector<Circle> circlesA;
+std::vector<Circle> circlesB;
+std::vector<SDL_Rect> walls;
+std::vector<SDL_Rect> tileClips;
+std::vector<SDL_Rect> tileSpots;
+std::vector<int> pointX;
+std::vector<int> pointY;
+Dot benchDot;
+BitmapFont benchFont;
+
+//Prototypes
+bool init();
+void clean_up();
+SDL_Surface *load_image(std::string filename);
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+void build_inputs();
+Sint64 now_nanoseconds();
+Uint64 read_cycles();
+bool pin_to_cpu(int cpu);
+BenchmarkResult measure(Benchmark &benchmark, int repetitions);
+
+//The originals
+bool check_collision(SDL_Rect A, SDL_Rect B);
+bool check_collision(std::vector<SDL_Rect> &A, std::vector<SDL_Rect> &B);
+bool check_collision(Circle &A, Circle &B);
+bool check_collision(Circle &A, std::vector<SDL_Rect> &B);
+double distance(int x1, int y1, int x2, int y2);
+Uint32 get_pixel32(int x, int y, SDL_Surface *surface);
+
+//Alternatives
+bool check_collision_branchless(SDL_Rect &A, SDL_Rect &B);
+bool check_collision_squared(Circle &A, Circle &B);
+bool check_collision_squared(Circle &A, std::vector<SDL_Rect> &B);
+double distance_multiply(int x1, int y1, int x2, int y2);
+int distance_squared(int x1, int y1, int x2, int y2);
+Uint32 get_pixel32_pitch(int x, int y, SDL_Surface *surface);
+
+//Benchmark bodies
+Uint32 run_rect_original();
+Uint32 run_rect_branchless();
+Uint32 run_boxes_original();
+Uint32 run_circle_original();
+Uint32 run_circle_squared();
+Uint32 run_circle_rects_original();
+Uint32 run_circle_rects_squared();
+Uint32 run_distance_original();
+Uint32 run_distance_multiply();
+Uint32 run_distance_squared();
+Uint32 run_pixel_original();
+Uint32 run_pixel_pitch();
+Uint32 run_build_font();
+Uint32 run_apply_tile();
+Uint32 run_apply_tile_rle();
+Uint32 run_apply_dot();
+Uint32 run_shift_original();
+Uint32 run_shift_offsets();
+bool always();
+bool have_font();
+bool have_tiles();
+bool have_dot();
+
+Benchmark benchmarks[] =
+{
+  {"check_collision rect/rect", "original", run_rect_original, TOTAL_ITEMS, always},
+  {"check_collision rect/rect", "branchless", run_rect_branchless, TOTAL_ITEMS, always},
+  {"check_collision boxes/walls", "original", run_boxes_original, TOTAL_ITEMS, always},
+  {"check_collision circle/circle", "original", run_circle_original, TOTAL_ITEMS, always},
+  {"check_collision circle/circle", "squared", run_circle_squared, TOTAL_ITEMS, always},
+  {"check_collision circle/rects", "original", run_circle_rects_original, TOTAL_ITEMS, always},
+  {"check_collision circle/rects", "squared", run_circle_rects_squared, TOTAL_ITEMS, always},
+  {"distance", "original", run_distance_original, TOTAL_ITEMS, always},
+  {"distance", "multiply", run_distance_multiply, TOTAL_ITEMS, always},
+  {"distance", "squared", run_distance_squared, TOTAL_ITEMS, always},
+  {"get_pixel32", "original", run_pixel_original, TOTAL_ITEMS, have_font},
+  {"get_pixel32", "pitch", run_pixel_pitch, TOTAL_ITEMS, have_font},
+  {"BitmapFont::build_font", "original", run_build_font, 256, have_font},
+  {"apply_surface tile", "colorkey", run_apply_tile, TOTAL_BLITS, have_tiles},
+  {"apply_surface tile", "colorkey rle", run_apply_tile_rle, TOTAL_BLITS, have_tiles},
+  {"apply_surface dot", "colorkey", run_apply_dot, TOTAL_BLITS, have_dot},
+  {"Dot::shift_boxes", "original", run_shift_original, TOTAL_ITEMS, always},
+  {"Dot::shift_boxes", "offsets", run_shift_offsets, TOTAL_ITEMS, always}
+};
+
+const int TOTAL_BENCHMARKS = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+//Functions
+int main(int argc, char* args[])
+{
+  std::string filter;
+  int repetitions = DEFAULT_REPETITIONS;
+  int cpu = sched_getcpu();
+
+  if(argc > 1)
+  {
+    filter = args[1];
+  }
+
+  if(argc > 2)
+  {
+    repetitions = atoi(args[2]);
+  }
+
+  if(argc > 3)
+  {
+    cpu = atoi(args[3]);
+  }
+
+  if(repetitions <= 0)
+  {
+    std::cerr << "Usage: " << args[0] << " [filter] [repetitions] [cpu]" << std::endl;
+    return 1;
+  }
+
+  //Migrations mid run show up as outliers and cold caches
+  if(pin_to_cpu(cpu) == false)
+  {
+    std::cerr << "Could not pin to CPU " << cpu << ", results will be noisier" << std::endl;
+  }
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  build_inputs();
+
+  std::cout.setf(std::ios::fixed);
+  std::cout.precision(2);
+
+  std::cout << "CPU " << cpu << ", " << repetitions << " repetitions, ";
+  std::cout << (HAVE_RDTSC ? "TSC cycles" : "nanoseconds") << " per item" << std::endl;
+
+  std::string group;
+  double baseline = 0;
+
+  for(int b = 0; b < TOTAL_BENCHMARKS; b++)
+  {
+    Benchmark &benchmark = benchmarks[b];
+
+    if((filter.empty() == false) && (std::string(benchmark.group).find(filter) == std::string::npos))
+    {
+      continue;
+    }
+
+    if(benchmark.available() == false)
+    {
+      std::cout << benchmark.group << " / " << benchmark.name << ": skipped, assets missing" << std::endl;
+      continue;
+    }
+
+    BenchmarkResult result = measure(benchmark, repetitions);
+
+    //The first entry of each group is what the rest are compared to
+    if(group != benchmark.group)
+    {
+      group = benchmark.group;
+      baseline = result.median;
+      std::cout << std::endl << group << std::endl;
+    }
+
+    std::cout << "  " << benchmark.name;
+    std::cout << "\tmedian " << result.median << " +- " << result.spread;
+    std::cout << "\tbest " << result.best;
+
+    if(result.median > 0)
+    {
+      std::cout << "\tx" << baseline / result.median;
+    }
+
+    std::cout << std::endl;
+  }
+
+  clean_up();
+  return 0;
+}
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+Uint64 read_cycles()
+{
+#if HAVE_RDTSC
+  return __rdtsc();
+#else
+  return now_nanoseconds();
+#endif
+}
+
+bool pin_to_cpu(int cpu)
+{
+  if(cpu < 0)
+  {
+    return false;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+BenchmarkResult measure(Benchmark &benchmark, int repetitions)
+{
+  //Warm caches, branch predictors and the CPU clock before counting
+  Sint64 warmupStart = now_nanoseconds();
+
+  for(int w = 0; (w < WARMUP_RUNS) || (now_nanoseconds() - warmupStart < WARMUP_NANOSECONDS); w++)
+  {
+    sink += benchmark.run();
+  }
+
+  std::vector<double> perItem;
+
+  for(int r = 0; r < repetitions; r++)
+  {
+    Uint64 start = read_cycles();
+    sink += benchmark.run();
+    Uint64 length = read_cycles() - start;
+
+    perItem.push_back((double)length / benchmark.items);
+  }
+
+  std::sort(perItem.begin(), perItem.end());
+
+  BenchmarkResult result;
+  result.median = perItem[perItem.size() / 2];
+  result.best = perItem[0];
+
+  //Median absolute deviation, not thrown off by the odd interrupt
+  std::vector<double> deviation;
+
+  for(unsigned int r = 0; r < perItem.size(); r++)
+  {
+    deviation.push_back(fabs(perItem[r] - result.median));
+  }
+
+  std::sort(deviation.begin(), deviation.end());
+  result.spread = deviation[deviation.size() / 2];
+
+  return result;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //SDL_DisplayFormat() needs a video mode, not a window
+  if(getenv("SDL_VIDEODRIVER") == NULL)
+  {
+    putenv((char *)"SDL_VIDEODRIVER=dummy");
+  }
+
+  if(SDL_Init(SDL_INIT_VIDEO) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  //Blits go to a plain surface in the screen's format
+  canvas = SDL_DisplayFormat(screen);
+
+  if(canvas == NULL)
+  {
+    return false;
+  }
+
+  //Missing sheets only skip the benchmarks that need them
+  fontSheet = load_image("lazyfont.png");
+  tileSheet = load_image("tiles.png");
+  dot = load_image("dot.bmp");
+
+  if(tileSheet != NULL)
+  {
+    tileSheetRle = SDL_DisplayFormat(tileSheet);
+
+    if(tileSheetRle != NULL)
+    {
+      SDL_SetColorKey(tileSheetRle, SDL_SRCCOLORKEY | SDL_RLEACCEL, SDL_MapRGB(tileSheetRle->format, 0, 0xFF, 0xFF));
+    }
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  SDL_FreeSurface(canvas);
+  SDL_FreeSurface(fontSheet);
+  SDL_FreeSurface(tileSheet);
+  SDL_FreeSurface(tileSheetRle);
+  SDL_FreeSurface(dot);
+
+  SDL_Quit();
+}
+
+void build_inputs()
+{
+  srand(RANDOM_SEED);
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    //Dot and tile sized boxes anywhere on screen, about a third overlapping
+    SDL_Rect a;
+    a.x = rand() % SCREEN_WIDTH;
+    a.y = rand() % SCREEN_HEIGHT;
+    a.w = DOT_WIDTH;
+    a.h = DOT_HEIGHT;
+
+    SDL_Rect b;
+    b.x = a.x - TILE_WIDTH + rand() % (TILE_WIDTH * 3);
+    b.y = a.y - TILE_HEIGHT + rand() % (TILE_HEIGHT * 3);
+    b.w = TILE_WIDTH;
+    b.h = TILE_HEIGHT;
+
+    rectsA.push_back(a);
+    rectsB.push_back(b);
+
+    Circle c = {rand() % SCREEN_WIDTH, rand() % SCREEN_HEIGHT, DOT_WIDTH / 2};
+    Circle d = {c.x - DOT_WIDTH * 2 + rand() % (DOT_WIDTH * 4), c.y - DOT_WIDTH * 2 + rand() % (DOT_WIDTH * 4), DOT_WIDTH / 2};
+    circlesA.push_back(c);
+    circlesB.push_back(d);
+
+    pointX.push_back(rand());
+    pointY.push_back(rand());
+  }
+
+  //Thin walls like the collision lessons use
+  for(int w = 0; w < TOTAL_WALLS; w++)
+  {
+    SDL_Rect wall;
+    wall.x = rand() % SCREEN_WIDTH;
+    wall.y = rand() % SCREEN_HEIGHT;
+    wall.w = 40;
+    wall.h = 200;
+
+    if(w % 2 == 1)
+    {
+      std::swap(wall.w, wall.h);
+    }
+
+    walls.push_back(wall);
+  }
+
+  //Every tile in the sheet, drawn at random spots
+  if(tileSheet != NULL)
+  {
+    for(int y = 0; y + TILE_HEIGHT <= tileSheet->h; y += TILE_HEIGHT)
+    {
+      for(int x = 0; x + TILE_WIDTH <= tileSheet->w; x += TILE_WIDTH)
+      {
+        SDL_Rect clip;
+        clip.x = x;
+        clip.y = y;
+        clip.w = TILE_WIDTH;
+        clip.h = TILE_HEIGHT;
+        tileClips.push_back(clip);
+      }
+    }
+  }
+
+  for(int b = 0; b < TOTAL_BLITS; b++)
+  {
+    SDL_Rect spot;
+    spot.x = rand() % SCREEN_WIDTH - TILE_WIDTH / 2;
+    spot.y = rand() % SCREEN_HEIGHT - TILE_HEIGHT / 2;
+    spot.w = 0;
+    spot.h = 0;
+    tileSpots.push_back(spot);
+  }
+}
+
+bool check_collision(SDL_Rect A, SDL_Rect B)
+{
+  int leftA, leftB;
+  int rightA, rightB;
+  int topA, topB;
+  int bottomA, bottomB;
+
+  leftA = A.x;
+  rightA = A.x + A.w;
+  topA = A.y;
+  bottomA = A.y + A.h;
+
+  leftB = B.x;
+  rightB = B.x + B.w;
+  topB = B.y;
+  bottomB = B.y + B.h;
+
+  if(bottomA <= topB)
+  {
+    return false;
+  }
+
+  if(topA >= bottomB)
+  {
+    return false;
+  }
+
+  if(rightA <= leftB)
+  {
+    return false;
+  }
+
+  if(leftA >= rightB)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+bool check_collision(std::vector<SDL_Rect> &A, std::vector<SDL_Rect> &B)
+{
+  int leftA, leftB;
+  int rightA, rightB;
+  int topA, topB;
+  int bottomA, bottomB;
+
+  for(unsigned int Abox = 0; Abox < A.size(); Abox++)
+  {
+    leftA = A[Abox].x;
+    rightA = A[Abox].x + A[Abox].w;
+    topA = A[Abox].y;
+    bottomA = A[Abox].y + A[Abox].h;
+
+    for(unsigned int Bbox = 0; Bbox < B.size(); Bbox++)
+    {
+      leftB = B[Bbox].x;
+      rightB = B[Bbox].x + B[Bbox].w;
+      topB = B[Bbox].y;
+      bottomB = B[Bbox].y + B[Bbox].h;
+
+      if(((bottomA <= topB) || (topA >= bottomB) || (rightA <= leftB) || (leftA >= rightB)) == false)
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+double distance(int x1, int y1, int x2, int y2)
+{
+  return sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2));
+}
+
+bool check_collision(Circle &A, Circle &B)
+{
+  if(distance(A.x, A.y, B.x, B.y) < (A.r + B.r))
+  {
+    return true;
+  }
+  return false;
+}
+
+bool check_collision(Circle &A, std::vector<SDL_Rect> &B)
+{
+  int cX, cY;
+
+  for(unsigned int Bbox = 0; Bbox < B.size(); Bbox++)
+  {
+    if(A.x < B[Bbox].x)
+    {
+      cX = B[Bbox].x;
+    }
+    else if(A.x > B[Bbox].x + B[Bbox].w)
+    {
+      cX = B[Bbox].x + B[Bbox].w;
+    }
+    else
+    {
+      cX = A.x;
+    }
+
+    if(A.y < B[Bbox].y)
+    {
+      cY = B[Bbox].y;
+    }
+    else if(A.y > B[Bbox].y + B[Bbox].h)
+    {
+      cY = B[Bbox].y + B[Bbox].h;
+    }
+    else
+    {
+      cY = A.y;
+    }
+
+    if(distance(A.x, A.y, cX, cY) < A.r)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+Uint32 get_pixel32(int x, int y, SDL_Surface *surface)
+{
+  Uint32 *pixels = (Uint32 *)surface->pixels;
+  return pixels[(y * surface->w) + x];
+}
+
+bool check_collision_branchless(SDL_Rect &A, SDL_Rect &B)
+{
+  //All four tests evaluated, no early outs to mispredict
+  return (A.y + A.h > B.y) & (A.y < B.y + B.h) & (A.x + A.w > B.x) & (A.x < B.x + B.w);
+}
+
+int distance_squared(int x1, int y1, int x2, int y2)
+{
+  int deltaX = x2 - x1;
+  int deltaY = y2 - y1;
+
+  return deltaX * deltaX + deltaY * deltaY;
+}
+
+double distance_multiply(int x1, int y1, int x2, int y2)
+{
+  return sqrt((double)distance_squared(x1, y1, x2, y2));
+}
+
+bool check_collision_squared(Circle &A, Circle &B)
+{
+  int reach = A.r + B.r;
+
+  return distance_squared(A.x, A.y, B.x, B.y) < reach * reach;
+}
+
+bool check_collision_squared(Circle &A, std::vector<SDL_Rect> &B)
+{
+  int reach = A.r * A.r;
+
+  for(unsigned int Bbox = 0; Bbox < B.size(); Bbox++)
+  {
+    int cX = std::max((int)B[Bbox].x, std::min(A.x, B[Bbox].x + B[Bbox].w));
+    int cY = std::max((int)B[Bbox].y, std::min(A.y, B[Bbox].y + B[Bbox].h));
+
+    if(distance_squared(A.x, A.y, cX, cY) < reach)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+Uint32 get_pixel32_pitch(int x, int y, SDL_Surface *surface)
+{
+  //Rows start pitch bytes apart, which need not be w * 4
+  Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+  return ((Uint32 *)row)[x];
+}
+
+Uint32 run_rect_original()
+{
+  Uint32 hits = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    hits += check_collision(rectsA[i], rectsB[i]);
+  }
+
+  return hits;
+}
+
+Uint32 run_rect_branchless()
+{
+  Uint32 hits = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    hits += check_collision_branchless(rectsA[i], rectsB[i]);
+  }
+
+  return hits;
+}
+
+Uint32 run_boxes_original()
+{
+  Uint32 hits = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    //As Dot::move() does before every test
+    benchDot.set_position(rectsA[i].x, rectsA[i].y);
+    benchDot.shift_boxes();
+    hits += check_collision(benchDot.get_rects(), walls);
+  }
+
+  return hits;
+}
+
+Uint32 run_circle_original()
+{
+  Uint32 hits = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    hits += check_collision(circlesA[i], circlesB[i]);
+  }
+
+  return hits;
+}
+
+Uint32 run_circle_squared()
+{
+  Uint32 hits = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    hits += check_collision_squared(circlesA[i], circlesB[i]);
+  }
+
+  return hits;
+}
+
+Uint32 run_circle_rects_original()
+{
+  Uint32 hits = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    hits += check_collision(circlesA[i], walls);
+  }
+
+  return hits;
+}
+
+Uint32 run_circle_rects_squared()
+{
+  Uint32 hits = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    hits += check_collision_squared(circlesA[i], walls);
+  }
+
+  return hits;
+}
+
+Uint32 run_distance_original()
+{
+  double total = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    total += distance(circlesA[i].x, circlesA[i].y, circlesB[i].x, circlesB[i].y);
+  }
+
+  return (Uint32)total;
+}
+
+Uint32 run_distance_multiply()
+{
+  double total = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    total += distance_multiply(circlesA[i].x, circlesA[i].y, circlesB[i].x, circlesB[i].y);
+  }
+
+  return (Uint32)total;
+}
+
+Uint32 run_distance_squared()
+{
+  //Only a fair swap where the distance is compared, not used
+  Uint32 total = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    total += distance_squared(circlesA[i].x, circlesA[i].y, circlesB[i].x, circlesB[i].y);
+  }
+
+  return total;
+}
+
+Uint32 run_pixel_original()
+{
+  Uint32 total = 0;
+
+  SDL_LockSurface(fontSheet);
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    total += get_pixel32(pointX[i] % fontSheet->w, pointY[i] % fontSheet->h, fontSheet);
+  }
+
+  SDL_UnlockSurface(fontSheet);
+
+  return total;
+}
+
+Uint32 run_pixel_pitch()
+{
+  Uint32 total = 0;
+
+  SDL_LockSurface(fontSheet);
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    total += get_pixel32_pitch(pointX[i] % fontSheet->w, pointY[i] % fontSheet->h, fontSheet);
+  }
+
+  SDL_UnlockSurface(fontSheet);
+
+  return total;
+}
+
+Uint32 run_build_font()
+{
+  benchFont.build_font(fontSheet);
+
+  return benchFont.get_width('A');
+}
+
+Uint32 run_apply_tile()
+{
+  for(int b = 0; b < TOTAL_BLITS; b++)
+  {
+    apply_surface(tileSpots[b].x, tileSpots[b].y, tileSheet, canvas, &tileClips[b % tileClips.size()]);
+  }
+
+  return ((Uint32 *)canvas->pixels)[0];
+}
+
+Uint32 run_apply_tile_rle()
+{
+  for(int b = 0; b < TOTAL_BLITS; b++)
+  {
+    apply_surface(tileSpots[b].x, tileSpots[b].y, tileSheetRle, canvas, &tileClips[b % tileClips.size()]);
+  }
+
+  return ((Uint32 *)canvas->pixels)[0];
+}
+
+Uint32 run_apply_dot()
+{
+  for(int b = 0; b < TOTAL_BLITS; b++)
+  {
+    apply_surface(tileSpots[b].x, tileSpots[b].y, dot, canvas);
+  }
+
+  return ((Uint32 *)canvas->pixels)[0];
+}
+
+Uint32 run_shift_original()
+{
+  Uint32 total = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    benchDot.set_position(rectsA[i].x, rectsA[i].y);
+    benchDot.shift_boxes();
+    total += benchDot.get_rects()[5].x;
+  }
+
+  return total;
+}
+
+Uint32 run_shift_offsets()
+{
+  Uint32 total = 0;
+
+  for(int i = 0; i < TOTAL_ITEMS; i++)
+  {
+    benchDot.set_position(rectsA[i].x, rectsA[i].y);
+    benchDot.shift_boxes_offsets();
+    total += benchDot.get_rects()[5].x;
+  }
+
+  return total;
+}
+
+bool always()
+{
+  return true;
+}
+
+bool have_font()
+{
+  return fontSheet != NULL;
+}
+
+bool have_tiles()
+{
+  return (tileSheet != NULL) && (tileSheetRle != NULL) && (tileClips.empty() == false);
+}
+
+bool have_dot()
+{
+  return dot != NULL;
+}
+
+BitmapFont::BitmapFont()
+{
+  bitmap = NULL;
+  newLine = 0;
+  space = 0;
+}
+
+int BitmapFont::get_width(int ascii)
+{
+  return chars[ascii].w;
+}
+
+void BitmapFont::build_font(SDL_Surface *surface)
+{
+  if(surface == NULL)
+  {
+    return;
+  }
+
+  bitmap = surface;
+  Uint32 bgColor = SDL_MapRGB(bitmap->format, 0, 0xFF, 0xFF);
+  int cellW = bitmap->w / 16;
+  int cellH = bitmap->h / 16;
+  int top = cellH;
+  int baseA = cellH;
+  int currentChar = 0;
+
+  for(int rows = 0; rows < 16; rows++)
+  {
+    for(int cols = 0; cols < 16; cols++)
+    {
+      chars[currentChar].x = cellW * cols;
+      chars[currentChar].y = cellH * rows;
+      chars[currentChar].w = cellW;
+      chars[currentChar].h = cellH;
+
+      for(int pCol = 0; pCol < cellW; pCol++)
+      {
+        for(int pRow = 0; pRow < cellH; pRow++)
+        {
+          int pX = (cellW * cols) + pCol;
+          int pY = (cellH * rows) + pRow;
+
+          if(get_pixel32(pX, pY, bitmap) != bgColor)
+          {
+            chars[currentChar].x = pX;
+            pCol = cellW;
+            pRow = cellH;
+          }
+        }
+      }
+
+      for(int pCol_w = cellW - 1; pCol_w >= 0; pCol_w--)
+      {
+        for(int pRow_w = 0; pRow_w < cellH; pRow_w++)
+        {
+          int pX = (cellW * cols) + pCol_w;
+          int pY = (cellH * rows) + pRow_w;
+
+          if(get_pixel32(pX, pY, bitmap) != bgColor)
+          {
+            chars[currentChar].w = (pX - chars[currentChar].x) + 1;
+            pCol_w = -1;
+            pRow_w = cellH;
+          }
+        }
+      }
+
+      for(int pRow = 0; pRow < cellH; pRow++)
+      {
+        for(int pCol = 0; pCol < cellW; pCol++)
+        {
+          int pX = (cellW * cols) + pCol;
+          int pY = (cellH * rows) + pRow;
+
+          if(get_pixel32(pX, pY, bitmap) != bgColor)
+          {
+            if(pRow < top)
+            {
+              top = pRow;
+            }
+
+            pCol = cellW;
+            pRow = cellH;
+          }
+        }
+      }
+
+      if(currentChar == 'A')
+      {
+        for(int pRow = cellH - 1; pRow >= 0; pRow--)
+        {
+          for(int pCol = 0; pCol < cellW; pCol++)
+          {
+            int pX = (cellW * cols) + pCol;
+            int pY = (cellH * rows) + pRow;
+
+            if(get_pixel32(pX, pY, bitmap) != bgColor)
+            {
+              baseA = pRow;
+              pCol = cellW;
+              pRow = -1;
+            }
+          }
+        }
+      }
+
+      currentChar++;
+    }
+  }
+
+  space = cellW / 2;
+  newLine = baseA - top;
+  for(int t = 0; t < 256; t++)
+  {
+    chars[t].y += top;
+    chars[t].h -= top;
+  }
+}
+
+Dot::Dot()
+{
+  x = 0;
+  y = 0;
+  box.resize(11);
+
+  //The per pixel collision lesson's dot, one box per run of rows
+  const int widths[11] = {6, 10, 14, 16, 18, 20, 18, 16, 14, 10, 6};
+  const int heights[11] = {1, 1, 1, 2, 2, 6, 2, 2, 1, 1, 1};
+
+  for(int set = 0; set < 11; set++)
+  {
+    box[set].w = widths[set];
+    box[set].h = heights[set];
+  }
+
+  //What shift_boxes() works out every call, done once
+  int r = 0;
+
+  for(int set = 0; set < 11; set++)
+  {
+    offsetX[set] = (DOT_WIDTH - box[set].w) / 2;
+    offsetY[set] = r;
+    r += box[set].h;
+  }
+
+  shift_boxes();
+}
+
+void Dot::set_position(int X, int Y)
+{
+  x = X;
+  y = Y;
+}
+
+void Dot::shift_boxes()
+{
+  int r = 0;
+
+  for(unsigned int set = 0; set < box.size(); set++)
+  {
+    box[set].x = x + (DOT_WIDTH - box[set].w) / 2;
+    box[set].y = y + r;
+    r += box[set].h;
+  }
+}
+
+void Dot::shift_boxes_offsets()
+{
+  SDL_Rect *boxes = &box[0];
+
+  for(int set = 0; set < 11; set++)
+  {
+    boxes[set].x = x + offsetX[set];
+    boxes[set].y = y + offsetY[set];
+  }
+}
+
+std::vector<SDL_Rect> &Dot::get_rects()
+{
+  return box;
+}
@@ -0,0 +1,897 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+
+//Blit and overdraw statistics for the scenes that draw pixels more than
+//once: the tiling lesson (tiles, then the dot), the particle engine (clear,
+//then type and shimmer per particle) and the scrolling background (two
+//background blits, then the dot). Every blit and fill to the screen goes
+//through apply_surface() or draw_fill(), which count calls and pixels
+//written and add one to a per pixel coverage count. The caption shows the current
+//frame; averages per scene print on exit.
+//1, 2 and 3 pick the scene, H swaps the picture for an overdraw heatmap:
+//black untouched, blue once, green twice, yellow three times, red four to
+//seven and white eight or more.
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 20;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+const int TOTAL_PARTICLES = 20;
+
+const int LEVEL_WIDTH = 1280;
+const int LEVEL_HEIGHT = 960;
+const int TILE_WIDTH = 80;
+const int TILE_HEIGHT = 80;
+const int TOTAL_TILES = 192;
+const int TILE_SPRITES = 12;
+
+const int SCENE_TILING = 0;
+const int SCENE_PARTICLES = 1;
+const int SCENE_SCROLLING = 2;
+const int TOTAL_SCENES = 3;
+
+//Frames between caption updates
+const int CAPTION_INTERVAL = 10;
+
+//Coverage counts stop here; the heatmap tops out well below it
+const int MAX_COVERAGE = 255;
+
+//Globals
+SDL_Surface *dot = NULL;
+SDL_Surface *shimmer = NULL;
+SDL_Surface *blue = NULL;
+SDL_Surface *green = NULL;
+SDL_Surface *red = NULL;
+SDL_Surface *background = NULL;
+SDL_Surface *tileSheet = NULL;
+SDL_Surface *screen = NULL;
+SDL_Event event;
+
+SDL_Rect camera = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+SDL_Rect clips[TILE_SPRITES];
+int tileTypes[TOTAL_TILES];
+
+//Structs/Classes
+class DrawStats
+{
+  private:
+    Uint8 coverage[SCREEN_WIDTH * SCREEN_HEIGHT];
+
+    //This frame
+    int blits;
+    int fills;
+    Uint64 pixels;
+
+    //Every frame since the scene was picked
+    int frames;
+    Uint64 totalBlits;
+    Uint64 totalFills;
+    Uint64 totalPixels;
+
+  public:
+    DrawStats();
+    void begin_frame();
+    void end_frame();
+    void count(SDL_Rect area, bool fill);
+    int get_blits();
+    int get_fills();
+    double get_overdraw();
+    int get_peak();
+    void show_heatmap(SDL_Surface *surface);
+    void report(std::ostream &out, std::string name);
+    void reset();
+};
+
+class Timer
+{
+  private:
+    int startTicks;
+    int pausedTicks;
+
+    bool paused;
+    bool started;
+
+  public:
+    Timer();
+    void start();
+    void stop();
+    void pause();
+    void unpause();
+    int get_ticks();
+    bool is_started();
+    bool is_paused();
+};
+
+class Particle
+{
+  private:
+    int x, y;
+    int frame;
+
+    SDL_Surface *type;
+
+  public:
+    Particle(int X, int Y);
+    void show();
+    bool is_dead();
+};
+
+class Dot
+{
+  private:
+    int x, y;
+    int xVel, yVel;
+    int areaWidth, areaHeight;
+    Particle *particles[TOTAL_PARTICLES];
+
+  public:
+    Dot();
+    ~Dot();
+    void handle_input();
+    void set_area(int width, int height);
+    void move();
+    void set_camera();
+    void show(int offsetX, int offsetY);
+    void show_particles();
+};
+
+DrawStats stats;
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+void draw_fill(SDL_Surface *destination, SDL_Rect *area, Uint32 color);
+SDL_Surface *load_image(std::string filename);
+bool load_files();
+void clean_up();
+void clip_tiles();
+bool load_map();
+void draw_tiling(Dot &myDot);
+void draw_particles(Dot &myDot);
+void draw_scrolling(Dot &myDot, int &bgX);
+void set_scene(Dot &myDot, int scene);
+
+const char *sceneNames[TOTAL_SCENES] = {"tiling", "particles", "scrolling background"};
+
+//Functions
+int main(int argc, char* args[])
+{
+  Timer fps;
+  Dot myDot;
+  bool quit = false;
+  bool heatmap = false;
+  int scene = SCENE_TILING;
+  int bgX = 0;
+  int frame = 0;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  clip_tiles();
+
+  if(load_map() == false)
+  {
+    return 1;
+  }
+
+  set_scene(myDot, scene);
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    fps.start();
+
+    while(SDL_PollEvent(&event))
+    {
+      myDot.handle_input();
+
+      if(event.type == SDL_KEYDOWN)
+      {
+        switch(event.key.keysym.sym)
+        {
+          case SDLK_1: case SDLK_2: case SDLK_3:
+            stats.report(std::cout, sceneNames[scene]);
+            scene = event.key.keysym.sym - SDLK_1;
+            set_scene(myDot, scene);
+            break;
+
+          case SDLK_h: heatmap = !heatmap; break;
+        }
+      }
+
+      if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    stats.begin_frame();
+
+    switch(scene)
+    {
+      case SCENE_TILING: draw_tiling(myDot); break;
+      case SCENE_PARTICLES: draw_particles(myDot); break;
+      case SCENE_SCROLLING: draw_scrolling(myDot, bgX); break;
+    }
+
+    stats.end_frame();
+
+    //The heatmap replaces the frame just drawn, its counts are already in
+    if(heatmap == true)
+    {
+      stats.show_heatmap(screen);
+    }
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    frame++;
+
+    if(frame % CAPTION_INTERVAL == 0)
+    {
+      std::stringstream caption;
+      caption.setf(std::ios::fixed);
+      caption.precision(2);
+      caption << "Overdraw " << sceneNames[scene] << ": " << stats.get_blits() << " blits, ";
+      caption << stats.get_fills() << " fills, " << stats.get_overdraw() << "x screen, peak ";
+      caption << stats.get_peak();
+
+      SDL_WM_SetCaption(caption.str().c_str(), NULL);
+    }
+
+    if(fps.get_ticks() < 1000 / FRAMES_PER_SECOND)
+    {
+      SDL_Delay((1000 / FRAMES_PER_SECOND) - fps.get_ticks());
+    }
+  }
+
+  stats.report(std::cout, sceneNames[scene]);
+
+  clean_up();
+  return 0;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  if(SDL_BlitSurface(source, clip, destination, &offset) != 0)
+  {
+    return;
+  }
+
+  //SDL leaves the clipped rectangle it actually drew in offset
+  if(destination == screen)
+  {
+    stats.count(offset, false);
+  }
+}
+
+void draw_fill(SDL_Surface *destination, SDL_Rect *area, Uint32 color)
+{
+  //SDL_FillRect() clips the rectangle it is given, so hand it a copy
+  SDL_Rect filled = (area != NULL) ? *area : destination->clip_rect;
+
+  if(SDL_FillRect(destination, &filled, color) != 0)
+  {
+    return;
+  }
+
+  if(destination == screen)
+  {
+    stats.count(filled, true);
+  }
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_VIDEO) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Overdraw", NULL);
+
+  srand(SDL_GetTicks());
+
+  return true;
+}
+
+bool load_files()
+{
+  dot = load_image("dot.bmp");
+  background = load_image("bg.png");
+  tileSheet = load_image("tiles.png");
+
+  if((dot == NULL) || (background == NULL) || (tileSheet == NULL))
+  {
+    return false;
+  }
+
+  red = load_image("red.bmp");
+  green = load_image("green.bmp");
+  blue = load_image("blue.bmp");
+  shimmer = load_image("shimmer.bmp");
+
+  if((shimmer == NULL) || (red == NULL) || (green == NULL) || (blue == NULL))
+  {
+    return false;
+  }
+
+  SDL_SetAlpha(red, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  SDL_SetAlpha(blue, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  SDL_SetAlpha(green, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  SDL_SetAlpha(shimmer, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+
+  return true;
+}
+
+void clean_up()
+{
+  SDL_FreeSurface(dot);
+  SDL_FreeSurface(background);
+  SDL_FreeSurface(tileSheet);
+  SDL_FreeSurface(red);
+  SDL_FreeSurface(green);
+  SDL_FreeSurface(blue);
+  SDL_FreeSurface(shimmer);
+
+  SDL_Quit();
+}
+
+void clip_tiles()
+{
+  //Sheet columns: plain colours, then left, middle and right edge pieces
+  const int sheetColumn[TILE_SPRITES] = {0, 0, 0, 2, 2, 3, 3, 3, 2, 1, 1, 1};
+  const int sheetRow[TILE_SPRITES] = {0, 1, 2, 1, 0, 0, 1, 2, 2, 2, 1, 0};
+
+  for(int t = 0; t < TILE_SPRITES; t++)
+  {
+    clips[t].x = sheetColumn[t] * TILE_WIDTH;
+    clips[t].y = sheetRow[t] * TILE_HEIGHT;
+    clips[t].w = TILE_WIDTH;
+    clips[t].h = TILE_HEIGHT;
+  }
+}
+
+bool load_map()
+{
+  std::ifstream map("lazy.map");
+
+  if(map == NULL)
+  {
+    return false;
+  }
+
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    int tileType = -1;
+    map >> tileType;
+
+    if((map.fail() == true) || (tileType < 0) || (tileType >= TILE_SPRITES))
+    {
+      return false;
+    }
+
+    tileTypes[t] = tileType;
+  }
+
+  return true;
+}
+
+void draw_tiling(Dot &myDot)
+{
+  myDot.move();
+  myDot.set_camera();
+
+  //Same test as Tile::show(): every tile the camera touches, then the dot
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    int tileX = (t % (LEVEL_WIDTH / TILE_WIDTH)) * TILE_WIDTH;
+    int tileY = (t / (LEVEL_WIDTH / TILE_WIDTH)) * TILE_HEIGHT;
+
+    if((tileX + TILE_WIDTH <= camera.x) || (tileX >= camera.x + camera.w))
+    {
+      continue;
+    }
+
+    if((tileY + TILE_HEIGHT <= camera.y) || (tileY >= camera.y + camera.h))
+    {
+      continue;
+    }
+
+    apply_surface(tileX - camera.x, tileY - camera.y, tileSheet, screen, &clips[tileTypes[t]]);
+  }
+
+  myDot.show(camera.x, camera.y);
+}
+
+void draw_particles(Dot &myDot)
+{
+  myDot.move();
+
+  draw_fill(screen, NULL, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+  myDot.show(0, 0);
+  myDot.show_particles();
+}
+
+void draw_scrolling(Dot &myDot, int &bgX)
+{
+  bgX -= 2;
+
+  if(bgX <= -background->w)
+  {
+    bgX = 0;
+  }
+
+  apply_surface(bgX, 0, background, screen);
+  apply_surface(bgX + background->w, 0, background, screen);
+
+  myDot.move();
+  myDot.show(0, 0);
+}
+
+void set_scene(Dot &myDot, int scene)
+{
+  if(scene == SCENE_TILING)
+  {
+    myDot.set_area(LEVEL_WIDTH, LEVEL_HEIGHT);
+  }
+  else
+  {
+    myDot.set_area(SCREEN_WIDTH, SCREEN_HEIGHT);
+  }
+
+  stats.reset();
+}
+
+DrawStats::DrawStats()
+{
+  reset();
+}
+
+void DrawStats::reset()
+{
+  blits = 0;
+  fills = 0;
+  pixels = 0;
+  frames = 0;
+  totalBlits = 0;
+  totalFills = 0;
+  totalPixels = 0;
+
+  memset(coverage, 0, sizeof(coverage));
+}
+
+void DrawStats::begin_frame()
+{
+  blits = 0;
+  fills = 0;
+  pixels = 0;
+
+  memset(coverage, 0, sizeof(coverage));
+}
+
+void DrawStats::end_frame()
+{
+  frames++;
+  totalBlits += blits;
+  totalFills += fills;
+  totalPixels += pixels;
+}
+
+void DrawStats::count(SDL_Rect area, bool fill)
+{
+  //Clipped away entirely, nothing was written
+  if((area.w == 0) || (area.h == 0))
+  {
+    return;
+  }
+
+  if(fill == true)
+  {
+    fills++;
+  }
+  else
+  {
+    blits++;
+  }
+
+  //The whole rectangle; colour keyed pixels are still read even if skipped
+  pixels += area.w * area.h;
+
+  for(int y = area.y; y < area.y + area.h; y++)
+  {
+    Uint8 *row = coverage + y * SCREEN_WIDTH;
+
+    for(int x = area.x; x < area.x + area.w; x++)
+    {
+      if(row[x] < MAX_COVERAGE)
+      {
+        row[x]++;
+      }
+    }
+  }
+}
+
+int DrawStats::get_blits()
+{
+  return blits;
+}
+
+int DrawStats::get_fills()
+{
+  return fills;
+}
+
+double DrawStats::get_overdraw()
+{
+  return (double)pixels / (SCREEN_WIDTH * SCREEN_HEIGHT);
+}
+
+int DrawStats::get_peak()
+{
+  int peak = 0;
+
+  for(int p = 0; p < SCREEN_WIDTH * SCREEN_HEIGHT; p++)
+  {
+    if(coverage[p] > peak)
+    {
+      peak = coverage[p];
+    }
+  }
+
+  return peak;
+}
+
+void DrawStats::show_heatmap(SDL_Surface *surface)
+{
+  //Colour per coverage count, eight and up share white
+  Uint32 colors[9];
+  colors[0] = SDL_MapRGB(surface->format, 0, 0, 0);
+  colors[1] = SDL_MapRGB(surface->format, 0, 0, 0xC0);
+  colors[2] = SDL_MapRGB(surface->format, 0, 0xC0, 0);
+  colors[3] = SDL_MapRGB(surface->format, 0xFF, 0xFF, 0);
+  colors[4] = SDL_MapRGB(surface->format, 0xFF, 0x40, 0);
+  colors[5] = colors[4];
+  colors[6] = colors[4];
+  colors[7] = colors[4];
+  colors[8] = SDL_MapRGB(surface->format, 0xFF, 0xFF, 0xFF);
+
+  if(SDL_MUSTLOCK(surface))
+  {
+    SDL_LockSurface(surface);
+  }
+
+  for(int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+    Uint8 *counts = coverage + y * SCREEN_WIDTH;
+
+    for(int x = 0; x < SCREEN_WIDTH; x++)
+    {
+      row[x] = colors[(counts[x] < 8) ? counts[x] : 8];
+    }
+  }
+
+  if(SDL_MUSTLOCK(surface))
+  {
+    SDL_UnlockSurface(surface);
+  }
+}
+
+void DrawStats::report(std::ostream &out, std::string name)
+{
+  if(frames == 0)
+  {
+    return;
+  }
+
+  out.setf(std::ios::fixed);
+  out.precision(2);
+
+  out << name << " over " << frames << " frames: ";
+  out << (double)totalBlits / frames << " blits, ";
+  out << (double)totalFills / frames << " fills, ";
+  out << (double)totalPixels / frames << " pixels per frame (";
+  out << (double)totalPixels / frames / (SCREEN_WIDTH * SCREEN_HEIGHT) << "x the screen)" << std::endl;
+}
+
+Timer::Timer()
+{
+  startTicks = 0;
+  pausedTicks = 0;
+  paused = false;
+  started = false;
+}
+
+void Timer::start()
+{
+  started = true;
+  paused = false;
+  startTicks = SDL_GetTicks();
+}
+
+void Timer::stop()
+{
+  started = false;
+  paused = false;
+}
+
+int Timer::get_ticks()
+{
+  if(started == true)
+  {
+    if(paused == true)
+    {
+      return pausedTicks;
+    }
+    else
+    {
+      return SDL_GetTicks() - startTicks;
+    }
+  }
+  return 0;
+}
+
+void Timer::pause()
+{
+  if((started == true) && (paused == false))
+  {
+    paused = true;
+    pausedTicks = SDL_GetTicks() - startTicks;
+  }
+}
+
+void Timer::unpause()
+{
+  if(paused == true)
+  {
+    paused = false;
+    startTicks = SDL_GetTicks() - pausedTicks;
+    pausedTicks = 0;
+  }
+}
+
+bool Timer::is_started()
+{
+  return started;
+}
+
+bool Timer::is_paused()
+{
+  return paused;
+}
+
+Dot::Dot()
+{
+  x = 0;
+  y = 0;
+  xVel = 0;
+  yVel = 0;
+  areaWidth = SCREEN_WIDTH;
+  areaHeight = SCREEN_HEIGHT;
+
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    particles[p] = new Particle(x, y);
+  }
+}
+
+Dot::~Dot()
+{
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    delete particles[p];
+  }
+}
+
+void Dot::handle_input()
+{
+  if(event.type == SDL_KEYDOWN)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel += DOT_WIDTH / 2; break;
+      case SDLK_LEFT: xVel -= DOT_WIDTH / 2; break;
+    }
+  }
+  else if(event.type == SDL_KEYUP)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel -= DOT_WIDTH / 2; break;
+      case SDLK_LEFT: xVel += DOT_WIDTH / 2; break;
+    }
+  }
+}
+
+void Dot::set_area(int width, int height)
+{
+  areaWidth = width;
+  areaHeight = height;
+
+  //Back inside if the new area is smaller
+  if(x + DOT_WIDTH > areaWidth)
+  {
+    x = areaWidth - DOT_WIDTH;
+  }
+
+  if(y + DOT_HEIGHT > areaHeight)
+  {
+    y = areaHeight - DOT_HEIGHT;
+  }
+}
+
+void Dot::move()
+{
+  x += xVel;
+
+  if((x < 0) || (x + DOT_WIDTH > areaWidth))
+  {
+    x -= xVel;
+  }
+
+  y += yVel;
+
+  if((y < 0) || (y + DOT_HEIGHT > areaHeight))
+  {
+    y -= yVel;
+  }
+}
+
+void Dot::set_camera()
+{
+  camera.x = (x + DOT_WIDTH / 2) - SCREEN_WIDTH / 2;
+  camera.y = (y + DOT_HEIGHT / 2) - SCREEN_HEIGHT / 2;
+
+  if(camera.x < 0)
+  {
+    camera.x = 0;
+  }
+
+  if(camera.y < 0)
+  {
+    camera.y = 0;
+  }
+
+  if(camera.x > LEVEL_WIDTH - camera.w)
+  {
+    camera.x = LEVEL_WIDTH - camera.w;
+  }
+
+  if(camera.y > LEVEL_HEIGHT - camera.h)
+  {
+    camera.y = LEVEL_HEIGHT - camera.h;
+  }
+}
+
+void Dot::show(int offsetX, int offsetY)
+{
+  apply_surface(x - offsetX, y - offsetY, dot, screen);
+}
+
+void Dot::show_particles()
+{
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    if(particles[p]->is_dead() == true)
+    {
+      delete particles[p];
+      particles[p] = new Particle(x, y);
+    }
+  }
+
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    particles[p]->show();
+  }
+}
+
+Particle::Particle(int X, int Y)
+{
+  x = X - 5 + (rand() % 25);
+  y = Y - 5 + (rand() % 25);
+
+  frame = rand() % 5;
+
+  switch(rand() % 3)
+  {
+    case 0: type = red; break;
+    case 1: type = green; break;
+    case 2: type = blue; break;
+  }
+}
+
+void Particle::show()
+{
+  apply_surface(x, y, type, screen);
+
+  if(frame % 2 == 0)
+  {
+    apply_surface(x, y, shimmer, screen);
+  }
+
+  frame++;
+}
+
+bool Particle::is_dead()
+{
+  if(frame > 10)
+  {
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,197 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+//Offline tool: bundles loose asset files into one pack that asset_pack maps
+//into memory at startup.
+//Usage: pack_builder <pack file> <asset> [<asset> ...]
+//
+//Layout:
+//  PackHeader
+//  PackEntry[entryCount], sorted by name
+//  name bytes
+//  entry data, each entry starting on a PACK_ALIGN boundary
+
+//Constants
+const Uint32 PACK_MAGIC = 0x4B415053;
+const Uint32 PACK_VERSION = 1;
+const Uint64 PACK_ALIGN = 4096;
+
+//Structs/Classes
+struct PackHeader
+{
+  Uint32 magic;
+  Uint32 version;
+  Uint32 entryCount;
+  Uint32 nameBytes;
+};
+
+struct PackEntry
+{
+  Uint32 nameOffset;
+  Uint32 nameLength;
+  Uint64 offset;
+  Uint64 size;
+};
+
+struct SourceFile
+{
+  std::string name;
+  std::vector<char> data;
+};
+
+//Prototypes
+bool read_file(std::string filename, std::vector<char> &data);
+bool by_name(const SourceFile &A, const SourceFile &B);
+Uint64 align(Uint64 offset);
+
+//Functions
+int main(int argc, char* args[])
+{
+  std::vector<SourceFile> files;
+
+  if(argc < 3)
+  {
+    std::cerr << "Usage: " << args[0] << " <pack file> <asset> [<asset> ...]" << std::endl;
+    return 1;
+  }
+
+  for(int a = 2; a < argc; a++)
+  {
+    SourceFile file;
+
+    //Entries are looked up by the same relative path the games open
+    file.name = args[a];
+
+    if(read_file(file.name, file.data) == false)
+    {
+      std::cerr << "Could not read " << file.name << std::endl;
+      return 1;
+    }
+
+    files.push_back(file);
+  }
+
+  //The runtime does a binary search over the index
+  std::sort(files.begin(), files.end(), by_name);
+
+  for(unsigned int f = 1; f < files.size(); f++)
+  {
+    if(files[f].name == files[f - 1].name)
+    {
+      std::cerr << "Duplicate asset " << files[f].name << std::endl;
+      return 1;
+    }
+  }
+
+  PackHeader header;
+  header.magic = PACK_MAGIC;
+  header.version = PACK_VERSION;
+  header.entryCount = files.size();
+  header.nameBytes = 0;
+
+  std::vector<PackEntry> entries(files.size());
+
+  for(unsigned int f = 0; f < files.size(); f++)
+  {
+    entries[f].nameOffset = header.nameBytes;
+    entries[f].nameLength = files[f].name.size();
+    header.nameBytes += files[f].name.size();
+  }
+
+  Uint64 offset = sizeof(PackHeader) + sizeof(PackEntry) * entries.size() + header.nameBytes;
+
+  for(unsigned int f = 0; f < files.size(); f++)
+  {
+    offset = align(offset);
+    entries[f].offset = offset;
+    entries[f].size = files[f].data.size();
+    offset += entries[f].size;
+  }
+
+  std::ofstream pack(args[1], std::ios::out | std::ios::binary);
+
+  if(pack == NULL)
+  {
+    return 1;
+  }
+
+  pack.write((char *)&header, sizeof(header));
+
+  if(entries.empty() == false)
+  {
+    pack.write((char *)&entries[0], sizeof(PackEntry) * entries.size());
+  }
+
+  for(unsigned int f = 0; f < files.size(); f++)
+  {
+    pack.write(files[f].name.data(), files[f].name.size());
+  }
+
+  for(unsigned int f = 0; f < files.size(); f++)
+  {
+    //Pad up to the entry so it starts on a page of its own
+    std::vector<char> padding(entries[f].offset - (Uint64)pack.tellp(), 0);
+
+    if(padding.empty() == false)
+    {
+      pack.write(&padding[0], padding.size());
+    }
+
+    if(files[f].data.empty() == false)
+    {
+      pack.write(&files[f].data[0], files[f].data.size());
+    }
+  }
+
+  if(pack.fail() == true)
+  {
+    std::cerr << "Could not write " << args[1] << std::endl;
+    return 1;
+  }
+
+  pack.close();
+
+  std::cout << "Packed " << files.size() << " assets into " << args[1] << " (" << offset << " bytes)" << std::endl;
+
+  return 0;
+}
+
+bool read_file(std::string filename, std::vector<char> &data)
+{
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+
+  if(file == NULL)
+  {
+    return false;
+  }
+
+  file.seekg(0, std::ios::end);
+  std::streamoff size = file.tellg();
+  file.seekg(0, std::ios::beg);
+
+  data.resize(size);
+
+  if(size > 0)
+  {
+    file.read(&data[0], size);
+  }
+
+  bool good = (file.fail() == false);
+  file.close();
+
+  return good;
+}
+
+bool by_name(const SourceFile &A, const SourceFile &B)
+{
+  return A.name < B.name;
+}
+
+Uint64 align(Uint64 offset)
+{
+  return (offset + PACK_ALIGN - 1) & ~(PACK_ALIGN - 1);
+}
@@ -0,0 +1,940 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+
+//The tiling lesson with hardware performance counters read around each
+//part of the frame: input, move, render and flip. Cycles, instructions,
+//L1D and last level cache misses and branch misses are counted through
+//perf_event_open() in one group, so they are always scheduled together.
+//On exit every phase prints its share of cycles, IPC, misses per thousand
+//instructions and branch miss rate.
+//Only user space is counted, which works at the default
+//perf_event_paranoid level. Where the counters can't be opened, such as
+//VMs without a PMU, the lesson runs without them. Build with
+//-DPERF_COUNTERS_ENABLED=0 and every PERF_ macro compiles to nothing.
+
+#ifndef PERF_COUNTERS_ENABLED
+#ifdef __linux__
+#define PERF_COUNTERS_ENABLED 1
+#else
+#define PERF_COUNTERS_ENABLED 0
+#endif
+#endif
+
+#if PERF_COUNTERS_ENABLED
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#define PERF_OPEN() perfCounters.open()
+#define PERF_FRAME() perfCounters.start_frame()
+#define PERF_PHASE(phase) perfCounters.end_phase(phase)
+#define PERF_REPORT() perfCounters.report(std::cout)
+#else
+#define PERF_OPEN()
+#define PERF_FRAME()
+#define PERF_PHASE(phase)
+#define PERF_REPORT()
+#endif
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 20;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+
+const int LEVEL_WIDTH = 1280;
+const int LEVEL_HEIGHT = 960;
+const int TILE_WIDTH = 80;
+const int TILE_HEIGHT = 80;
+const int TOTAL_TILES = 192;
+const int TILE_SPRITES = 12;
+
+const int TILE_RED = 0;
+const int TILE_GREEN = 1;
+const int TILE_BLUE = 2;
+const int TILE_CENTER= 3;
+const int TILE_TOP= 4;
+const int TILE_TOPRIGHT= 5;
+const int TILE_RIGHT= 6;
+const int TILE_BOTTOMRIGHT= 7;
+const int TILE_BOTTOM= 8;
+const int TILE_BOTTOMLEFT= 9;
+const int TILE_LEFT= 10;
+const int TILE_TOPLEFT= 11;
+
+//Frame phases
+const int PHASE_INPUT = 0;
+const int PHASE_MOVE = 1;
+const int PHASE_RENDER = 2;
+const int PHASE_FLIP = 3;
+const int TOTAL_PHASES = 4;
+
+//Counters, in the order they join the group
+const int COUNTER_CYCLES = 0;
+const int COUNTER_INSTRUCTIONS = 1;
+const int COUNTER_L1D_MISSES = 2;
+const int COUNTER_LLC_MISSES = 3;
+const int COUNTER_BRANCHES = 4;
+const int COUNTER_BRANCH_MISSES = 5;
+const int TOTAL_COUNTERS = 6;
+
+//Globals
+SDL_Surface *dot = NULL;
+SDL_Surface *screen = NULL;
+SDL_Surface *tileSheet = NULL;
+
+SDL_Event event;
+
+SDL_Rect camera = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+SDL_Rect clips[TILE_SPRITES];
+
+//Structs/Classes
+class Timer
+{
+  private:
+    int startTicks;
+    int pausedTicks;
+
+    bool paused;
+    bool started;
+
+  public:
+    Timer();
+    void start();
+    void stop();
+    void pause();
+    void unpause();
+    int get_ticks();
+    bool is_started();
+    bool is_paused();
+};
+
+class Tile
+{
+  private:
+    SDL_Rect box;
+    int type;
+
+  public:
+    Tile(int x, int y, int tileType);
+    void show();
+    int get_type();
+    SDL_Rect get_box();
+};
+
+class Dot
+{
+  private:
+    SDL_Rect box;
+    int xVel, yVel;
+
+  public:
+    Dot();
+    void handle_input();
+    void move(Tile *tiles[]);
+    void show();
+    void set_camera();
+};
+
+#if PERF_COUNTERS_ENABLED
+class PerfCounters
+{
+  private:
+    int fds[TOTAL_COUNTERS];
+
+    //Where each counter sits in a group read, -1 if it didn't open
+    int slot[TOTAL_COUNTERS];
+    int members;
+
+    Uint64 last[TOTAL_COUNTERS];
+    Uint64 lastEnabled, lastRunning;
+    double totals[TOTAL_PHASES][TOTAL_COUNTERS];
+
+    //Nanoseconds each phase's group was actually on the PMU
+    Uint64 runningTotals[TOTAL_PHASES];
+    Uint64 frames;
+
+    bool read_group(Uint64 values[], Uint64 &enabled, Uint64 &running);
+
+  public:
+    PerfCounters();
+    ~PerfCounters();
+    bool open();
+    void start_frame();
+    void end_phase(int phase);
+    void report(std::ostream &out);
+};
+
+PerfCounters perfCounters;
+#endif
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *load_image(std::string filename);
+bool load_files();
+void clean_up(Tile *tiles[]);
+void clip_tiles();
+bool set_tiles(Tile *tiles[]);
+bool touches_wall(SDL_Rect box, Tile *tiles[]);
+bool check_collision(SDL_Rect A, SDL_Rect B);
+
+//Functions
+int main(int argc, char* args[])
+{
+  Timer fps;
+  Dot myDot;
+  bool quit = false;
+  Tile *tiles[TOTAL_TILES];
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  clip_tiles();
+
+  if(set_tiles(tiles) == false)
+  {
+    return 1;
+  }
+
+  PERF_OPEN();
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+
+    fps.start();
+    PERF_FRAME();
+
+    while(SDL_PollEvent(&event))
+    {
+      myDot.handle_input();
+
+      if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    PERF_PHASE(PHASE_INPUT);
+
+    myDot.move(tiles);
+    myDot.set_camera();
+
+    PERF_PHASE(PHASE_MOVE);
+
+    for(int t = 0; t < TOTAL_TILES; t++)
+    {
+      tiles[t]->show();
+    }
+
+    myDot.show();
+
+    PERF_PHASE(PHASE_RENDER);
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    PERF_PHASE(PHASE_FLIP);
+
+    if(fps.get_ticks() < 1000 / FRAMES_PER_SECOND)
+    {
+      SDL_Delay((1000 / FRAMES_PER_SECOND) - fps.get_ticks());
+    }
+  }
+
+  PERF_REPORT();
+
+  clean_up(tiles);
+  return 0;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Perf Counters", NULL);
+
+  srand(SDL_GetTicks());
+
+  return true;
+}
+
+bool load_files()
+{
+  dot = load_image("dot.png");
+
+  if(dot == NULL)
+  {
+    return false;
+  }
+
+  tileSheet = load_image("tiles.png");
+
+  if(tileSheet == NULL)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void clean_up(Tile *tiles[])
+{
+  SDL_FreeSurface(dot);
+  SDL_FreeSurface(tileSheet);
+
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    delete tiles[t];
+  }
+
+  SDL_Quit();
+}
+
+void clip_tiles()
+{
+  clips[TILE_RED].x = 0;
+  clips[TILE_RED].y = 0;
+  clips[TILE_RED].w = TILE_WIDTH;
+  clips[TILE_RED].h = TILE_HEIGHT;
+
+  clips[TILE_GREEN].x = 0;
+  clips[TILE_GREEN].y = 80;
+  clips[TILE_GREEN].w = TILE_WIDTH;
+  clips[TILE_GREEN].h = TILE_HEIGHT;
+
+  clips[TILE_BLUE].x = 0;
+  clips[TILE_BLUE].y = 160;
+  clips[TILE_BLUE].w = TILE_WIDTH;
+  clips[TILE_BLUE].h = TILE_HEIGHT;
+
+  clips[TILE_TOPLEFT].x = 80;
+  clips[TILE_TOPLEFT].y = 0;
+  clips[TILE_TOPLEFT].w = TILE_WIDTH;
+  clips[TILE_TOPLEFT].h = TILE_HEIGHT;
+
+  clips[TILE_LEFT].x = 80;
+  clips[TILE_LEFT].y = 80;
+  clips[TILE_LEFT].w = TILE_WIDTH;
+  clips[TILE_LEFT].h = TILE_HEIGHT;
+
+  clips[TILE_BOTTOMLEFT].x = 80;
+  clips[TILE_BOTTOMLEFT].y = 160;
+  clips[TILE_BOTTOMLEFT].w = TILE_WIDTH;
+  clips[TILE_BOTTOMLEFT].h = TILE_HEIGHT;
+
+  clips[TILE_TOP].x = 160;
+  clips[TILE_TOP].y = 0;
+  clips[TILE_TOP].w = TILE_WIDTH;
+  clips[TILE_TOP].h = TILE_HEIGHT;
+
+  clips[TILE_CENTER].x = 160;
+  clips[TILE_CENTER].y = 80;
+  clips[TILE_CENTER].w = TILE_WIDTH;
+  clips[TILE_CENTER].h = TILE_HEIGHT;
+
+  clips[TILE_BOTTOM].x = 160;
+  clips[TILE_BOTTOM].y = 160;
+  clips[TILE_BOTTOM].w = TILE_WIDTH;
+  clips[TILE_BOTTOM].h = TILE_HEIGHT;
+
+  clips[TILE_TOPRIGHT].x = 240;
+  clips[TILE_TOPRIGHT].y = 0;
+  clips[TILE_TOPRIGHT].w = TILE_WIDTH;
+  clips[TILE_TOPRIGHT].h = TILE_HEIGHT;
+
+  clips[TILE_RIGHT].x = 240;
+  clips[TILE_RIGHT].y = 80;
+  clips[TILE_RIGHT].w = TILE_WIDTH;
+  clips[TILE_RIGHT].h = TILE_HEIGHT;
+
+  clips[TILE_BOTTOMRIGHT].x = 240;
+  clips[TILE_BOTTOMRIGHT].y = 160;
+  clips[TILE_BOTTOMRIGHT].w = TILE_WIDTH;
+  clips[TILE_BOTTOMRIGHT].h = TILE_HEIGHT;
+}
+
+bool touches_wall(SDL_Rect box, Tile *tiles[])
+{
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    if((tiles[t]->get_type() >= TILE_CENTER) && (tiles[t]->get_type() <= TILE_TOPLEFT))
+    {
+      if(check_collision(box, tiles[t]->get_box()) == true)
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool check_collision(SDL_Rect A, SDL_Rect B)
+{
+  int leftA, leftB;
+  int rightA, rightB;
+  int topA, topB;
+  int bottomA, bottomB;
+  leftA = A.x;
+  rightA = A.x + A.w;
+  topA = A.y;
+  bottomA = A.y + A.h;
+  leftB = B.x;
+  topB = B.y;
+  rightB = B.x + B.w;
+  bottomB = B.y + B.h;
+
+  if(bottomA <= topB)
+  {
+    return false;
+  }
+
+  if(topA >= bottomB)
+  {
+    return false;
+  }
+
+  if(rightA <= leftB)
+  {
+    return false;
+  }
+
+  if(leftA >= rightB)
+  {
+    return false;
+  }
+  return true;
+}
+
+Timer::Timer()
+{
+  startTicks = 0;
+  pausedTicks = 0;
+  paused = false;
+  started = false;
+}
+
+void Timer::start()
+{
+  started = true;
+  paused = false;
+  startTicks = SDL_GetTicks();
+}
+
+void Timer::stop()
+{
+  started = false;
+  paused = false;
+}
+
+int Timer::get_ticks()
+{
+  if(started == true)
+  {
+    if(paused == true)
+    {
+      return pausedTicks;
+    }
+    else
+    {
+      return SDL_GetTicks() - startTicks;
+    }
+  }
+  return 0;
+}
+
+void Timer::pause()
+{
+  if((started == true) && (paused == false))
+  {
+    paused = true;
+    pausedTicks = SDL_GetTicks() - startTicks;
+  }
+}
+
+void Timer::unpause()
+{
+  if(paused == true)
+  {
+    paused = false;
+    startTicks = SDL_GetTicks() - pausedTicks;
+    pausedTicks = 0;
+  }
+}
+
+bool Timer::is_started()
+{
+  return started;
+}
+
+bool Timer::is_paused()
+{
+  return paused;
+}
+
+Dot::Dot()
+{
+  box.x = 0;
+  box.y = 0;
+  box.w = DOT_WIDTH;
+  box.h = DOT_HEIGHT;
+  xVel = 0;
+  yVel = 0;
+}
+
+void Dot::set_camera()
+{
+  camera.x = (box.x + DOT_WIDTH / 2) - SCREEN_WIDTH/2;
+  camera.y = (box.y + DOT_HEIGHT/ 2) - SCREEN_HEIGHT/2;
+
+  if(camera.x < 0)
+  {
+    camera.x = 0;
+  }
+
+  if(camera.y < 0)
+  {
+    camera.y = 0;
+  }
+
+  if(camera.x > LEVEL_WIDTH - camera.w)
+  {
+    camera.x = LEVEL_WIDTH - camera.w;
+  }
+
+  if(camera.y > LEVEL_HEIGHT - camera.h)
+  {
+    camera.y = LEVEL_HEIGHT - camera.h;
+  }
+}
+
+void Dot::handle_input()
+{
+  if(event.type == SDL_KEYDOWN)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel += DOT_WIDTH/ 2; break;
+      case SDLK_LEFT: xVel -= DOT_WIDTH/ 2; break;
+    }
+  }
+  else if(event.type == SDL_KEYUP)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel -= DOT_WIDTH/ 2; break;
+      case SDLK_LEFT: xVel += DOT_WIDTH/ 2; break;
+    }
+  }
+}
+
+void Dot::move(Tile *tiles[])
+{
+  box.x += xVel;
+  if((box.x < 0) || (box.x + DOT_WIDTH > LEVEL_WIDTH) || touches_wall(box, tiles))
+  {
+    box.x -= xVel;
+  }
+
+  box.y += yVel;
+
+  if((box.y < 0) || (box.y + DOT_HEIGHT > LEVEL_HEIGHT) || touches_wall(box, tiles))
+  {
+    box.y -= yVel;
+  }
+}
+
+void Dot::show()
+{
+  apply_surface(box.x - camera.x, box.y - camera.y, dot, screen);
+}
+
+Tile::Tile(int x, int y, int tileType)
+{
+  box.x = x;
+  box.y = y;
+  box.w = TILE_WIDTH;
+  box.h = TILE_HEIGHT;
+  type = tileType;
+}
+
+void Tile::show()
+{
+  if(check_collision(camera, box) == true)
+  {
+    apply_surface(box.x - camera.x, box.y - camera.y, tileSheet, screen, &clips[type]);
+  }
+}
+
+int Tile::get_type()
+{
+  return type;
+}
+
+SDL_Rect Tile::get_box()
+{
+  return box;
+}
+
+bool set_tiles(Tile *tiles[])
+{
+  int x = 0, y = 0;
+  std::ifstream map("lazy.map");
+
+  if(map == NULL)
+  {
+    return false;
+  }
+
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    int tileType = -1;
+    map >> tileType;
+    if(map.fail() == true)
+    {
+      map.close();
+      return false;
+    }
+
+    if((tileType >= 0) && (tileType < TILE_SPRITES))
+    {
+      tiles[t] = new Tile(x, y, tileType);
+    }
+    else
+    {
+      map.close();
+      return false;
+    }
+
+    x += TILE_WIDTH;
+    if(x >= LEVEL_WIDTH)
+    {
+      x = 0;
+      y+= TILE_HEIGHT;
+    }
+  }
+
+  map.close();
+  return true;
+}
+
+#if PERF_COUNTERS_ENABLED
+PerfCounters::PerfCounters()
+{
+  members = 0;
+  frames = 0;
+  lastEnabled = 0;
+  lastRunning = 0;
+
+  for(int c = 0; c < TOTAL_COUNTERS; c++)
+  {
+    fds[c] = -1;
+    slot[c] = -1;
+    last[c] = 0;
+  }
+
+  for(int p = 0; p < TOTAL_PHASES; p++)
+  {
+    runningTotals[p] = 0;
+
+    for(int c = 0; c < TOTAL_COUNTERS; c++)
+    {
+      totals[p][c] = 0;
+    }
+  }
+}
+
+PerfCounters::~PerfCounters()
+{
+  for(int c = 0; c < TOTAL_COUNTERS; c++)
+  {
+    if(fds[c] != -1)
+    {
+      close(fds[c]);
+    }
+  }
+}
+
+bool PerfCounters::open()
+{
+  const Uint32 types[TOTAL_COUNTERS] =
+  {
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE
+  };
+
+  const Uint64 configs[TOTAL_COUNTERS] =
+  {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  for(int c = 0; c < TOTAL_COUNTERS; c++)
+  {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = types[c];
+    attr.config = configs[c];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    //The leader holds the group back until everything has joined
+    attr.disabled = (c == COUNTER_CYCLES) ? 1 : 0;
+
+    int leader = (c == COUNTER_CYCLES) ? -1 : fds[COUNTER_CYCLES];
+    fds[c] = syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+
+    if(fds[c] == -1)
+    {
+      //Without cycles there is nothing to hang the rest on
+      if(c == COUNTER_CYCLES)
+      {
+        std::cerr << "perf_event_open failed, running without counters" << std::endl;
+        return false;
+      }
+
+      std::cerr << "Counter " << c << " is not available on this CPU" << std::endl;
+      continue;
+    }
+
+    slot[c] = members;
+    members++;
+  }
+
+  ioctl(fds[COUNTER_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds[COUNTER_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+  return true;
+}
+
+bool PerfCounters::read_group(Uint64 values[], Uint64 &enabled, Uint64 &running)
+{
+  //nr, time enabled, time running, then one value per member
+  Uint64 buffer[3 + TOTAL_COUNTERS];
+
+  if(fds[COUNTER_CYCLES] == -1)
+  {
+    return false;
+  }
+
+  if(read(fds[COUNTER_CYCLES], buffer, sizeof(buffer)) < (ssize_t)(3 * sizeof(Uint64)))
+  {
+    return false;
+  }
+
+  enabled = buffer[1];
+  running = buffer[2];
+
+  for(int c = 0; c < TOTAL_COUNTERS; c++)
+  {
+    values[c] = (slot[c] != -1) ? buffer[3 + slot[c]] : 0;
+  }
+
+  return true;
+}
+
+void PerfCounters::start_frame()
+{
+  //Whatever ran since the last flip, the frame cap's sleep included, is left out
+  if(read_group(last, lastEnabled, lastRunning) == true)
+  {
+    frames++;
+  }
+}
+
+void PerfCounters::end_phase(int phase)
+{
+  Uint64 values[TOTAL_COUNTERS];
+  Uint64 enabled, running;
+
+  if(read_group(values, enabled, running) == false)
+  {
+    return;
+  }
+
+  //If the group was multiplexed with other perf users, scale up to the whole phase
+  double scale = 1.0;
+
+  if((running > lastRunning) && (enabled > lastEnabled))
+  {
+    scale = (double)(enabled - lastEnabled) / (running - lastRunning);
+  }
+
+  for(int c = 0; c < TOTAL_COUNTERS; c++)
+  {
+    totals[phase][c] += (values[c] - last[c]) * scale;
+    last[c] = values[c];
+  }
+
+  runningTotals[phase] += running - lastRunning;
+  lastEnabled = enabled;
+  lastRunning = running;
+}
+
+void PerfCounters::report(std::ostream &out)
+{
+  if(frames == 0)
+  {
+    return;
+  }
+
+  const char *names[TOTAL_PHASES] = {"input", "move", "render", "flip"};
+
+  double allCycles = 0;
+  Uint64 allRunning = 0;
+
+  for(int p = 0; p < TOTAL_PHASES; p++)
+  {
+    allCycles += totals[p][COUNTER_CYCLES];
+    allRunning += runningTotals[p];
+  }
+
+  //Zero time running means the kernel never put the group on the PMU
+  if(allRunning == 0)
+  {
+    out << "Counters over " << frames << " frames: the group was never scheduled, nothing was counted" << std::endl;
+    return;
+  }
+
+  out.setf(std::ios::fixed);
+  out.precision(2);
+
+  out << "Counters over " << frames << " frames (user space)" << std::endl;
+  out << "phase\tcycles/frame\tshare\tIPC\tL1D MPKI\tLLC MPKI\tbranch miss" << std::endl;
+
+  for(int p = 0; p < TOTAL_PHASES; p++)
+  {
+    double *total = totals[p];
+    double thousands = total[COUNTER_INSTRUCTIONS] / 1000.0;
+
+    out << names[p];
+
+    if(runningTotals[p] == 0)
+    {
+      out << "\tnot counted, the group was never scheduled in this phase" << std::endl;
+      continue;
+    }
+    out << "\t" << total[COUNTER_CYCLES] / frames;
+    out << "\t" << ((allCycles > 0) ? 100.0 * total[COUNTER_CYCLES] / allCycles : 0) << "%";
+    out << "\t" << ((total[COUNTER_CYCLES] > 0) ? total[COUNTER_INSTRUCTIONS] / total[COUNTER_CYCLES] : 0);
+
+    //Counters that didn't open show as n/a rather than a misleading zero
+    if((slot[COUNTER_L1D_MISSES] != -1) && (thousands > 0))
+    {
+      out << "\t" << total[COUNTER_L1D_MISSES] / thousands;
+    }
+    else
+    {
+      out << "\tn/a";
+    }
+
+    if((slot[COUNTER_LLC_MISSES] != -1) && (thousands > 0))
+    {
+      out << "\t" << total[COUNTER_LLC_MISSES] / thousands;
+    }
+    else
+    {
+      out << "\tn/a";
+    }
+
+    if((slot[COUNTER_BRANCHES] != -1) && (slot[COUNTER_BRANCH_MISSES] != -1) && (total[COUNTER_BRANCHES] > 0))
+    {
+      out << "\t" << 100.0 * total[COUNTER_BRANCH_MISSES] / total[COUNTER_BRANCHES] << "%";
+    }
+    else
+    {
+      out << "\tn/a";
+    }
+
+    out << std::endl;
+  }
+}
+#endif
@@ -0,0 +1,600 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include "SDL/SDL_thread.h"
+#include <sstream>
+#include <string>
+#include <cstdlib>
+
+//The scrolling lesson with simulation and presentation on separate threads.
+//A simulation thread steps the dots at a fixed rate and writes each result
+//as an immutable Snapshot (camera and sprites) into a triple buffer. The
+//main thread handles events and draws the newest snapshot, so a blocking
+//SDL_Flip() no longer holds up the next simulation step and the picture is
+//never more than one snapshot behind.
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int TICKS_PER_SECOND = 60;
+const int LEVEL_WIDTH = 1280;
+const int LEVEL_HEIGHT = 960;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+const int TOTAL_DRONES = 200;
+const int TOTAL_SPRITES = TOTAL_DRONES + 1;
+
+//Sprite ids a snapshot refers to
+const int SPRITE_DOT = 0;
+const int TOTAL_SPRITE_IMAGES = 1;
+
+//Globals
+SDL_Surface *spriteImages[TOTAL_SPRITE_IMAGES];
+SDL_Surface *background = NULL;
+SDL_Surface *screen = NULL;
+SDL_Event event;
+
+//Structs/Classes
+struct Sprite
+{
+  int x, y;
+  int id;
+};
+
+struct Snapshot
+{
+  int tick;
+  Uint32 published;
+  SDL_Rect camera;
+  int count;
+  Sprite sprites[TOTAL_SPRITES];
+};
+
+struct InputState
+{
+  int xVel, yVel;
+  bool quit;
+  SDL_mutex *lock;
+};
+
+class TripleBuffer
+{
+  private:
+    Snapshot slots[3];
+    int writing;
+    int ready;
+    int reading;
+    bool fresh;
+    int dropped;
+
+    SDL_mutex *lock;
+    SDL_cond *published;
+
+  public:
+    TripleBuffer();
+    ~TripleBuffer();
+    Snapshot *get_write();
+    void publish();
+    Snapshot *acquire(Uint32 timeout);
+    int take_dropped();
+};
+
+class Dot
+{
+  private:
+    int x, y;
+    int xVel, yVel;
+  public:
+    Dot();
+    void place(int startX, int startY, int startXVel, int startYVel);
+    void set_velocity(int newXVel, int newYVel);
+    void move();
+    void bounce();
+    void set_camera(SDL_Rect &camera);
+    void store(Sprite &sprite);
+};
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *load_image(std::string filename);
+bool load_files();
+void clean_up();
+int simulate(void *data);
+void show_snapshot(Snapshot *snapshot);
+
+InputState input;
+TripleBuffer frames;
+
+//Functions
+int main(int argc, char* args[])
+{
+  bool quit = false;
+  int rendered = 0;
+  int simulated = 0;
+  int lastTick = 0;
+  Uint32 latency = 0;
+  Uint32 update = 0;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  input.xVel = 0;
+  input.yVel = 0;
+  input.quit = false;
+  input.lock = SDL_CreateMutex();
+
+  SDL_Thread *simulation = SDL_CreateThread(simulate, NULL);
+
+  if(simulation == NULL)
+  {
+    return 1;
+  }
+
+  update = SDL_GetTicks();
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    //Events must stay on the thread that set the video mode
+    while(SDL_PollEvent(&event))
+    {
+      int xVel = 0;
+      int yVel = 0;
+
+      if(event.type == SDL_KEYDOWN)
+      {
+        switch(event.key.keysym.sym)
+        {
+          case SDLK_RIGHT: xVel += DOT_WIDTH / 2; break;
+          case SDLK_LEFT: xVel -= DOT_WIDTH / 2; break;
+          case SDLK_UP: yVel -= DOT_HEIGHT / 2; break;
+          case SDLK_DOWN: yVel += DOT_HEIGHT / 2; break;
+        }
+      }
+      else if(event.type == SDL_KEYUP)
+      {
+        switch(event.key.keysym.sym)
+        {
+          case SDLK_RIGHT: xVel -= DOT_WIDTH / 2; break;
+          case SDLK_LEFT: xVel += DOT_WIDTH / 2; break;
+          case SDLK_UP: yVel += DOT_HEIGHT / 2; break;
+          case SDLK_DOWN: yVel -= DOT_HEIGHT / 2; break;
+        }
+      }
+      else if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+
+      SDL_mutexP(input.lock);
+      input.xVel += xVel;
+      input.yVel += yVel;
+      input.quit = quit;
+      SDL_mutexV(input.lock);
+    }
+
+    //Draw the newest snapshot, or wait a little for one
+    Snapshot *snapshot = frames.acquire(1000 / TICKS_PER_SECOND);
+
+    if(snapshot != NULL)
+    {
+      show_snapshot(snapshot);
+
+      if(SDL_Flip(screen) == -1)
+      {
+        quit = true;
+      }
+
+      latency += SDL_GetTicks() - snapshot->published;
+      simulated += snapshot->tick - lastTick;
+      lastTick = snapshot->tick;
+      rendered++;
+    }
+
+    if(SDL_GetTicks() - update > 1000)
+    {
+      std::stringstream caption;
+      caption << "Pipelined Scrolling - " << simulated << " ticks, " << rendered << " frames";
+      caption << ", " << frames.take_dropped() << " snapshots skipped";
+
+      if(rendered > 0)
+      {
+        caption << ", " << latency / rendered << " ms to screen";
+      }
+
+      SDL_WM_SetCaption(caption.str().c_str(), NULL);
+
+      rendered = 0;
+      simulated = 0;
+      latency = 0;
+      update = SDL_GetTicks();
+    }
+  }
+
+  SDL_mutexP(input.lock);
+  input.quit = true;
+  SDL_mutexV(input.lock);
+
+  SDL_WaitThread(simulation, NULL);
+
+  SDL_DestroyMutex(input.lock);
+
+  clean_up();
+  return 0;
+}
+
+int simulate(void *data)
+{
+  Dot player;
+  Dot drones[TOTAL_DRONES];
+  int tick = 0;
+
+  //Same drones every run
+  srand(1);
+
+  for(int d = 0; d < TOTAL_DRONES; d++)
+  {
+    drones[d].place(rand() % (LEVEL_WIDTH - DOT_WIDTH), rand() % (LEVEL_HEIGHT - DOT_HEIGHT), rand() % 9 - 4, rand() % 9 - 4);
+  }
+
+  Uint32 deadline = SDL_GetTicks();
+
+  while(true)
+  {
+    SDL_mutexP(input.lock);
+    bool quit = input.quit;
+    player.set_velocity(input.xVel, input.yVel);
+    SDL_mutexV(input.lock);
+
+    if(quit == true)
+    {
+      break;
+    }
+
+    player.move();
+
+    for(int d = 0; d < TOTAL_DRONES; d++)
+    {
+      drones[d].bounce();
+    }
+
+    tick++;
+
+    //Fill the back slot; the renderer never sees it half written
+    Snapshot *snapshot = frames.get_write();
+    snapshot->tick = tick;
+    player.set_camera(snapshot->camera);
+
+    snapshot->count = 0;
+
+    for(int d = 0; d < TOTAL_DRONES; d++)
+    {
+      drones[d].store(snapshot->sprites[snapshot->count++]);
+    }
+
+    player.store(snapshot->sprites[snapshot->count++]);
+
+    snapshot->published = SDL_GetTicks();
+    frames.publish();
+
+    //Keep a fixed rate from the deadline, not from now
+    deadline += 1000 / TICKS_PER_SECOND;
+    Uint32 now = SDL_GetTicks();
+
+    if((Sint32)(deadline - now) > 0)
+    {
+      SDL_Delay(deadline - now);
+    }
+    else if(now - deadline > 250)
+    {
+      //Too far behind to catch up, start over
+      deadline = now;
+    }
+  }
+
+  return 0;
+}
+
+void show_snapshot(Snapshot *snapshot)
+{
+  SDL_Rect camera = snapshot->camera;
+
+  apply_surface(0, 0, background, screen, &camera);
+
+  for(int s = 0; s < snapshot->count; s++)
+  {
+    Sprite &sprite = snapshot->sprites[s];
+
+    //Skip what the camera can't see
+    if((sprite.x + DOT_WIDTH <= camera.x) || (sprite.x >= camera.x + camera.w))
+    {
+      continue;
+    }
+
+    if((sprite.y + DOT_HEIGHT <= camera.y) || (sprite.y >= camera.y + camera.h))
+    {
+      continue;
+    }
+
+    apply_surface(sprite.x - camera.x, sprite.y - camera.y, spriteImages[sprite.id], screen);
+  }
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  //Set up screen
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  //If there was an error setting up the screen
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Pipelined Scrolling", NULL);
+
+  return true;
+}
+
+bool load_files()
+{
+  spriteImages[SPRITE_DOT] = load_image("dot.bmp");
+  background = load_image("bg.png");
+
+  if(spriteImages[SPRITE_DOT] == NULL)
+  {
+    return false;
+  }
+
+  if(background == NULL)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  for(int i = 0; i < TOTAL_SPRITE_IMAGES; i++)
+  {
+    SDL_FreeSurface(spriteImages[i]);
+  }
+
+  SDL_FreeSurface(background);
+
+  SDL_Quit();
+}
+
+TripleBuffer::TripleBuffer()
+{
+  writing = 0;
+  ready = 1;
+  reading = 2;
+  fresh = false;
+  dropped = 0;
+
+  lock = SDL_CreateMutex();
+  published = SDL_CreateCond();
+}
+
+TripleBuffer::~TripleBuffer()
+{
+  SDL_DestroyCond(published);
+  SDL_DestroyMutex(lock);
+}
+
+Snapshot *TripleBuffer::get_write()
+{
+  //Only the simulation thread touches this slot
+  return &slots[writing];
+}
+
+void TripleBuffer::publish()
+{
+  SDL_mutexP(lock);
+
+  //The renderer never took the last one, it is simply replaced
+  if(fresh == true)
+  {
+    dropped++;
+  }
+
+  int swap = ready;
+  ready = writing;
+  writing = swap;
+  fresh = true;
+
+  SDL_CondSignal(published);
+  SDL_mutexV(lock);
+}
+
+Snapshot *TripleBuffer::acquire(Uint32 timeout)
+{
+  Snapshot *snapshot = NULL;
+
+  SDL_mutexP(lock);
+
+  if(fresh == false)
+  {
+    SDL_CondWaitTimeout(published, lock, timeout);
+  }
+
+  //Swap in the newest snapshot; the old reading slot goes back to the pool
+  if(fresh == true)
+  {
+    int swap = ready;
+    ready = reading;
+    reading = swap;
+    fresh = false;
+
+    snapshot = &slots[reading];
+  }
+
+  SDL_mutexV(lock);
+
+  return snapshot;
+}
+
+int TripleBuffer::take_dropped()
+{
+  SDL_mutexP(lock);
+  int count = dropped;
+  dropped = 0;
+  SDL_mutexV(lock);
+
+  return count;
+}
+
+Dot::Dot()
+{
+  x = 0;
+  y = 0;
+  xVel = 0;
+  yVel = 0;
+}
+
+void Dot::place(int startX, int startY, int startXVel, int startYVel)
+{
+  x = startX;
+  y = startY;
+  xVel = startXVel;
+  yVel = startYVel;
+}
+
+void Dot::set_velocity(int newXVel, int newYVel)
+{
+  xVel = newXVel;
+  yVel = newYVel;
+}
+
+void Dot::move()
+{
+  x += xVel;
+
+  if((x < 0) || (x + DOT_WIDTH > LEVEL_WIDTH))
+  {
+    x -= xVel;
+  }
+
+  y += yVel;
+
+  if((y < 0) || (y + DOT_HEIGHT > LEVEL_HEIGHT))
+  {
+    y -= yVel;
+  }
+}
+
+void Dot::bounce()
+{
+  x += xVel;
+
+  if((x < 0) || (x + DOT_WIDTH > LEVEL_WIDTH))
+  {
+    x -= xVel;
+    xVel = -xVel;
+  }
+
+  y += yVel;
+
+  if((y < 0) || (y + DOT_HEIGHT > LEVEL_HEIGHT))
+  {
+    y -= yVel;
+    yVel = -yVel;
+  }
+}
+
+void Dot::set_camera(SDL_Rect &camera)
+{
+  camera.x = (x + DOT_WIDTH / 2) - SCREEN_WIDTH / 2;
+  camera.y = (y + DOT_HEIGHT / 2) - SCREEN_HEIGHT / 2;
+  camera.w = SCREEN_WIDTH;
+  camera.h = SCREEN_HEIGHT;
+
+  if(camera.x < 0)
+  {
+    camera.x = 0;
+  }
+  if(camera.y < 0)
+  {
+    camera.y = 0;
+  }
+  if(camera.x > LEVEL_WIDTH - camera.w)
+  {
+    camera.x = LEVEL_WIDTH - camera.w;
+  }
+  if(camera.y > LEVEL_HEIGHT - camera.h)
+  {
+    camera.y = LEVEL_HEIGHT - camera.h;
+  }
+}
+
+void Dot::store(Sprite &sprite)
+{
+  sprite.x = x;
+  sprite.y = y;
+  sprite.id = SPRITE_DOT;
+}
@@ -0,0 +1,440 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include "SDL/SDL_ttf.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <time.h>
+
+//The advanced timing lesson with a Timer built on CLOCK_MONOTONIC instead of
+//SDL_GetTicks(). It keeps the same start/stop/pause/unpause behaviour, so it
+//drops into any lesson, and adds nanosecond reads. Every frame is also put
+//in a FrameHistogram that prints p50/p95/p99/max when the program exits.
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 60;
+
+//Histogram buckets are 10 microseconds wide and cover one second
+const Sint64 BUCKET_NANOSECONDS = 10000;
+const int TOTAL_BUCKETS = 100000;
+
+SDL_Surface *background = NULL;
+SDL_Surface *screen = NULL;
+SDL_Surface *seconds = NULL;
+SDL_Surface *startStop= NULL;
+SDL_Surface *pauseMessage= NULL;
+
+SDL_Event event;
+TTF_Font *font = NULL;
+SDL_Color textColor = {0, 0, 0};
+
+class Timer
+{
+  private:
+    Sint64 startTime;
+    Sint64 pausedTime;
+
+    bool paused;
+    bool started;
+
+  public:
+    Timer();
+    void start();
+    void stop();
+    void pause();
+    void unpause();
+    int get_ticks();
+    Sint64 get_nanoseconds();
+    double get_milliseconds();
+    bool is_started();
+    bool is_paused();
+};
+
+class FrameHistogram
+{
+  private:
+    std::vector<int> buckets;
+    int count;
+    Sint64 total;
+    Sint64 longest;
+
+  public:
+    FrameHistogram();
+    void record(Sint64 nanoseconds);
+    double percentile(double percent);
+    void report(std::ostream &out);
+};
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+Timer::Timer()
+{
+  startTime = 0;
+  pausedTime = 0;
+  paused = false;
+  started = false;
+}
+
+void Timer::start()
+{
+  started = true;
+  paused = false;
+  startTime = now_nanoseconds();
+}
+
+void Timer::stop()
+{
+  started = false;
+  paused = false;
+}
+
+Sint64 Timer::get_nanoseconds()
+{
+  if(started == true)
+  {
+    if(paused == true)
+    {
+      return pausedTime;
+    }
+    else
+    {
+      return now_nanoseconds() - startTime;
+    }
+  }
+  return 0;
+}
+
+int Timer::get_ticks()
+{
+  //Whole milliseconds, same as the SDL_GetTicks() timer
+  return get_nanoseconds() / 1000000;
+}
+
+double Timer::get_milliseconds()
+{
+  return get_nanoseconds() / 1000000.0;
+}
+
+void Timer::pause()
+{
+  if((started == true) && (paused == false))
+  {
+    paused = true;
+    pausedTime = now_nanoseconds() - startTime;
+  }
+}
+
+void Timer::unpause()
+{
+  if(paused == true)
+  {
+    paused = false;
+    startTime = now_nanoseconds() - pausedTime;
+    pausedTime = 0;
+  }
+}
+
+bool Timer::is_started()
+{
+  return started;
+}
+
+bool Timer::is_paused()
+{
+  return paused;
+}
+
+FrameHistogram::FrameHistogram()
+{
+  buckets.resize(TOTAL_BUCKETS, 0);
+  count = 0;
+  total = 0;
+  longest = 0;
+}
+
+void FrameHistogram::record(Sint64 nanoseconds)
+{
+  Sint64 bucket = nanoseconds / BUCKET_NANOSECONDS;
+
+  //Anything past a second lands in the last bucket; max stays exact
+  if(bucket >= TOTAL_BUCKETS)
+  {
+    bucket = TOTAL_BUCKETS - 1;
+  }
+
+  buckets[bucket]++;
+  count++;
+  total += nanoseconds;
+
+  if(nanoseconds > longest)
+  {
+    longest = nanoseconds;
+  }
+}
+
+double FrameHistogram::percentile(double percent)
+{
+  //Upper edge of the bucket holding the requested rank, in milliseconds
+  int rank = (int)(count * percent / 100.0 + 0.5);
+  int seen = 0;
+
+  if(rank < 1)
+  {
+    rank = 1;
+  }
+
+  for(int b = 0; b < TOTAL_BUCKETS; b++)
+  {
+    seen += buckets[b];
+
+    if(seen >= rank)
+    {
+      Sint64 edge = (b + 1) * BUCKET_NANOSECONDS;
+
+      if(edge > longest)
+      {
+        edge = longest;
+      }
+
+      return edge / 1000000.0;
+    }
+  }
+
+  return longest / 1000000.0;
+}
+
+void FrameHistogram::report(std::ostream &out)
+{
+  if(count == 0)
+  {
+    return;
+  }
+
+  out << "Frames: " << count << std::endl;
+  out << "Frame time (ms) avg " << (total / count) / 1000000.0;
+  out << " p50 " << percentile(50);
+  out << " p95 " << percentile(95);
+  out << " p99 " << percentile(99);
+  out << " max " << longest / 1000000.0 << std::endl;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  //Return the optimized image
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  //Set up screen
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  //If there was an error setting up the screen
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  if(TTF_Init() == -1)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Precise Timing", NULL);
+
+  return true;
+}
+
+bool load_files()
+{
+  //Load image
+  background = load_image("background.png");
+
+  //Open the font
+  font = TTF_OpenFont("lazy.ttf", 30);
+
+  //If there was an error loading the images
+  if(background == NULL)
+  {
+    return false;
+  }
+
+  if(font == NULL)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  //Free the images
+  SDL_FreeSurface(background);
+  SDL_FreeSurface(startStop);
+  SDL_FreeSurface(pauseMessage);
+
+  TTF_CloseFont(font);
+
+  TTF_Quit();
+  SDL_Quit();
+}
+
+int main(int argc, char* args[])
+{
+  bool quit = false;
+  Timer fps;
+  Timer myTimer;
+  FrameHistogram frameTimes;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  startStop = TTF_RenderText_Solid(font, "Press S to start or stop the timer", textColor);
+  pauseMessage = TTF_RenderText_Solid(font, "Press P to pause or unpause the timer", textColor);
+
+  myTimer.start();
+  fps.start();
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    while(SDL_PollEvent(&event))
+    {
+      if(event.type == SDL_KEYDOWN)
+      {
+        if(event.key.keysym.sym == SDLK_s)
+        {
+          if(myTimer.is_started() == true)
+          {
+            myTimer.stop();
+          }
+          else
+          {
+            myTimer.start();
+          }
+        }
+        if(event.key.keysym.sym == SDLK_p)
+        {
+          if(myTimer.is_paused() == true)
+          {
+            myTimer.unpause();
+          }
+          else
+          {
+            myTimer.pause();
+          }
+        }
+      }
+      else if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    apply_surface(0, 0, background, screen);
+    apply_surface((SCREEN_WIDTH - startStop->w) / 2, 200, startStop, screen);
+    apply_surface((SCREEN_WIDTH - pauseMessage->w) / 2, 300, pauseMessage, screen);
+
+    std::stringstream time;
+    time << "Timer: " << myTimer.get_nanoseconds() / 1000000000.0;
+
+    seconds = TTF_RenderText_Solid(font, time.str().c_str(), textColor);
+
+    apply_surface((SCREEN_WIDTH - seconds->w) / 2, 50, seconds, screen);
+
+    SDL_FreeSurface(seconds);
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    //Cap on the fractional budget instead of whole milliseconds
+    double budget = 1000.0 / FRAMES_PER_SECOND;
+
+    if(fps.get_milliseconds() < budget)
+    {
+      //SDL_Delay() only takes whole milliseconds, so spin off the fraction
+      SDL_Delay((Uint32)(budget - fps.get_milliseconds()));
+
+      while(fps.get_milliseconds() < budget)
+      {
+      }
+    }
+
+    //Frame to frame time, including the cap
+    frameTimes.record(fps.get_nanoseconds());
+    fps.start();
+  }
+
+  frameTimes.report(std::cout);
+
+  clean_up();
+  return 0;
+}
@@ -0,0 +1,1047 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//Repeatable benchmark over lesson scenes. Like headless, it renders with
+//SDL's dummy video driver. Input is scripted and goes through SDL_PushEvent()
+//and the scenes' own SDL_PollEvent()/handle_input() path. rand() is seeded
+//and every scene runs the same number of frames. Results are written as
+//JSON: fps, frame time percentiles, peak RSS, allocations made while
+//rendering and a framebuffer hash. Given a baseline from an earlier run,
+//anything more than REGRESSION_PERCENT worse is reported and the exit code
+//is 2.
+//Usage: scene_bench [frames] [results.json] [baseline.json]
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+const int LEVEL_WIDTH = 1280;
+const int LEVEL_HEIGHT = 960;
+const int TILE_WIDTH = 80;
+const int TILE_HEIGHT = 80;
+const int TOTAL_TILES = 192;
+const int TILE_SPRITES = 12;
+const int TOTAL_PARTICLES = 20;
+const int FOO_WIDTH = 64;
+const int FOO_HEIGHT = 205;
+const int RANDOM_SEED = 1;
+const double REGRESSION_PERCENT = 10.0;
+
+//Globals
+SDL_Surface *screen = NULL;
+SDL_Surface *dot = NULL;
+SDL_Surface *level = NULL;
+SDL_Surface *tileSheet = NULL;
+SDL_Surface *foo = NULL;
+SDL_Surface *red = NULL;
+SDL_Surface *green = NULL;
+SDL_Surface *blue = NULL;
+SDL_Surface *shimmer = NULL;
+SDL_Event event;
+SDL_Rect camera = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+SDL_Rect tileClips[TILE_SPRITES];
+SDL_Rect fooClips[2][4];
+int tileTypes[TOTAL_TILES];
+
+//Counted by the malloc wrappers below, only while a scene renders
+Uint64 allocations = 0;
+Uint64 allocatedBytes = 0;
+bool countAllocations = false;
+
+//Structs/Classes
+struct ScriptedKey
+{
+  int frame;
+  SDLKey key;
+  bool down;
+};
+
+//Walks every direction in turn, then repeats
+const ScriptedKey SCRIPT[] =
+{
+  {0, SDLK_RIGHT, true}, {90, SDLK_RIGHT, false},
+  {90, SDLK_DOWN, true}, {150, SDLK_DOWN, false},
+  {150, SDLK_LEFT, true}, {240, SDLK_LEFT, false},
+  {240, SDLK_UP, true}, {300, SDLK_UP, false}
+};
+
+const int SCRIPT_LENGTH = sizeof(SCRIPT) / sizeof(SCRIPT[0]);
+//One past the last entry, or its key-up would never fire
+const int SCRIPT_PERIOD = 301;
+
+struct Scene
+{
+  const char *name;
+  bool (*load)();
+  void (*reset)();
+  void (*handle_input)();
+  void (*render)();
+};
+
+struct SceneResult
+{
+  std::string name;
+  int frames;
+  double fps;
+  double average, p50, p95, p99, longest;
+  long peakRss;
+  Uint64 allocations;
+  Uint64 allocatedBytes;
+  Uint32 hash;
+};
+
+class Dot
+{
+  private:
+    int x, y;
+    int xVel, yVel;
+    int width, height;
+
+  public:
+    Dot();
+    void reset(int areaWidth, int areaHeight);
+    void handle_input();
+    void move();
+    void set_camera();
+    int get_x();
+    int get_y();
+};
+
+class Foo
+{
+  private:
+    int offSet;
+    int velocity;
+    int frame;
+    int status;
+
+  public:
+    Foo();
+    void handle_input();
+    void move();
+    void show();
+};
+
+struct Particle
+{
+  int x, y;
+  int frame;
+  SDL_Surface *type;
+};
+
+Dot player;
+Foo walker;
+Particle particles[TOTAL_PARTICLES];
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *load_image(std::string filename);
+void clean_up();
+Sint64 now_nanoseconds();
+Uint32 hash_surface(SDL_Surface *surface);
+void reset_peak_rss();
+long read_peak_rss();
+void push_script(int frame);
+bool run_scene(Scene &scene, int frames, SceneResult &result);
+void write_json(std::ostream &out, std::vector<SceneResult> &results, int frames);
+bool compare_baseline(std::string filename, std::vector<SceneResult> &results);
+bool load_particles();
+void reset_particles();
+void handle_dot();
+void render_particles();
+bool load_scrolling();
+void reset_level_dot();
+void render_scrolling();
+bool load_tiling();
+void render_tiling();
+bool load_animation();
+void reset_animation();
+void handle_foo();
+void render_animation();
+
+Scene scenes[] =
+{
+  {"particles", load_particles, reset_particles, handle_dot, render_particles},
+  {"scrolling", load_scrolling, reset_level_dot, handle_dot, render_scrolling},
+  {"tiling", load_tiling, reset_level_dot, handle_dot, render_tiling},
+  {"animation", load_animation, reset_animation, handle_foo, render_animation}
+};
+
+const int TOTAL_SCENES = sizeof(scenes) / sizeof(scenes[0]);
+
+#ifdef __GLIBC__
+//Count every heap allocation in the process, SDL's included
+extern "C"
+{
+  void *__libc_malloc(size_t size);
+  void *__libc_calloc(size_t count, size_t size);
+  void *__libc_realloc(void *pointer, size_t size);
+
+  void *malloc(size_t size)
+  {
+    if(countAllocations == true)
+    {
+      __sync_fetch_and_add(&allocations, 1);
+      __sync_fetch_and_add(&allocatedBytes, size);
+    }
+
+    return __libc_malloc(size);
+  }
+
+  void *calloc(size_t count, size_t size)
+  {
+    if(countAllocations == true)
+    {
+      __sync_fetch_and_add(&allocations, 1);
+      __sync_fetch_and_add(&allocatedBytes, count * size);
+    }
+
+    return __libc_calloc(count, size);
+  }
+
+  void *realloc(void *pointer, size_t size)
+  {
+    if(countAllocations == true)
+    {
+      __sync_fetch_and_add(&allocations, 1);
+      __sync_fetch_and_add(&allocatedBytes, size);
+    }
+
+    return __libc_realloc(pointer, size);
+  }
+}
+#endif
+
+//Functions
+int main(int argc, char* args[])
+{
+  int frames = 1200;
+  std::string resultsFile = "bench.json";
+  std::string baselineFile;
+
+  if(argc > 1)
+  {
+    frames = atoi(args[1]);
+  }
+
+  if(argc > 2)
+  {
+    resultsFile = args[2];
+  }
+
+  if(argc > 3)
+  {
+    baselineFile = args[3];
+  }
+
+  if(frames <= 0)
+  {
+    std::cerr << "Usage: " << args[0] << " [frames] [results.json] [baseline.json]" << std::endl;
+    return 1;
+  }
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  std::vector<SceneResult> results;
+
+  for(int s = 0; s < TOTAL_SCENES; s++)
+  {
+    SceneResult result;
+
+    if(run_scene(scenes[s], frames, result) == false)
+    {
+      std::cerr << "Could not run " << scenes[s].name << std::endl;
+      clean_up();
+      return 1;
+    }
+
+    results.push_back(result);
+  }
+
+  clean_up();
+
+  std::ofstream json(resultsFile.c_str());
+  write_json(json, results, frames);
+  write_json(std::cout, results, frames);
+
+  if(baselineFile.empty() == false)
+  {
+    if(compare_baseline(baselineFile, results) == false)
+    {
+      return 2;
+    }
+  }
+
+  return 0;
+}
+
+Sint64 now_nanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (Sint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+Uint32 hash_surface(SDL_Surface *surface)
+{
+  //FNV-1a over the visible bytes of each row, padding left out
+  Uint32 hash = 2166136261u;
+  int rowBytes = surface->w * surface->format->BytesPerPixel;
+
+  SDL_LockSurface(surface);
+
+  for(int y = 0; y < surface->h; y++)
+  {
+    Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+
+    for(int b = 0; b < rowBytes; b++)
+    {
+      hash ^= row[b];
+      hash *= 16777619u;
+    }
+  }
+
+  SDL_UnlockSurface(surface);
+
+  return hash;
+}
+
+void reset_peak_rss()
+{
+  //Linux resets VmHWM to the current RSS when 5 is written here
+  int file = open("/proc/self/clear_refs", O_WRONLY);
+
+  if(file != -1)
+  {
+    if(write(file, "5", 1) == -1)
+    {
+      //Older kernels; the peak then covers the whole run so far
+    }
+
+    close(file);
+  }
+}
+
+long read_peak_rss()
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+
+  while(std::getline(status, line))
+  {
+    if(line.compare(0, 6, "VmHWM:") == 0)
+    {
+      return atol(line.c_str() + 6);
+    }
+  }
+
+  return -1;
+}
+
+void push_script(int frame)
+{
+  int step = frame % SCRIPT_PERIOD;
+
+  for(int k = 0; k < SCRIPT_LENGTH; k++)
+  {
+    if(SCRIPT[k].frame != step)
+    {
+      continue;
+    }
+
+    SDL_Event key;
+    memset(&key, 0, sizeof(key));
+    key.type = SCRIPT[k].down ? SDL_KEYDOWN : SDL_KEYUP;
+    key.key.state = SCRIPT[k].down ? SDL_PRESSED : SDL_RELEASED;
+    key.key.keysym.sym = SCRIPT[k].key;
+
+    SDL_PushEvent(&key);
+  }
+}
+
+bool run_scene(Scene &scene, int frames, SceneResult &result)
+{
+  if(scene.load() == false)
+  {
+    return false;
+  }
+
+  //Same start, same randomness, same keys every run
+  srand(RANDOM_SEED);
+  scene.reset();
+
+  while(SDL_PollEvent(&event))
+  {
+  }
+
+  std::vector<Sint64> times;
+  times.reserve(frames);
+
+  Uint32 combined = 2166136261u;
+  Sint64 total = 0;
+
+  reset_peak_rss();
+  allocations = 0;
+  allocatedBytes = 0;
+
+  for(int frame = 0; frame < frames; frame++)
+  {
+    push_script(frame);
+
+    Sint64 start = now_nanoseconds();
+    countAllocations = true;
+
+    while(SDL_PollEvent(&event))
+    {
+      scene.handle_input();
+    }
+
+    scene.render();
+
+    if(SDL_Flip(screen) == -1)
+    {
+      countAllocations = false;
+      return false;
+    }
+
+    countAllocations = false;
+
+    Sint64 length = now_nanoseconds() - start;
+    times.push_back(length);
+    total += length;
+
+    //Hashing is not part of the frame
+    combined = (combined ^ hash_surface(screen)) * 16777619u;
+  }
+
+  std::sort(times.begin(), times.end());
+
+  result.name = scene.name;
+  result.frames = frames;
+  result.fps = frames / (total / 1000000000.0);
+  result.average = total / frames / 1000000.0;
+  result.p50 = times[frames / 2] / 1000000.0;
+  result.p95 = times[(frames * 95) / 100] / 1000000.0;
+  result.p99 = times[(frames * 99) / 100] / 1000000.0;
+  result.longest = times[frames - 1] / 1000000.0;
+  result.peakRss = read_peak_rss();
+  result.allocations = allocations;
+  result.allocatedBytes = allocatedBytes;
+  result.hash = combined;
+
+  return true;
+}
+
+void write_json(std::ostream &out, std::vector<SceneResult> &results, int frames)
+{
+  out.setf(std::ios::fixed);
+  out.precision(4);
+
+  out << "{\n";
+  out << "  \"seed\": " << RANDOM_SEED << ",\n";
+  out << "  \"frames\": " << frames << ",\n";
+  out << "  \"width\": " << SCREEN_WIDTH << ",\n";
+  out << "  \"height\": " << SCREEN_HEIGHT << ",\n";
+  out << "  \"scenes\": [\n";
+
+  for(unsigned int r = 0; r < results.size(); r++)
+  {
+    SceneResult &result = results[r];
+
+    out << "    {\"name\": \"" << result.name << "\"";
+    out << ", \"fps\": " << result.fps;
+    out << ", \"avg_ms\": " << result.average;
+    out << ", \"p50_ms\": " << result.p50;
+    out << ", \"p95_ms\": " << result.p95;
+    out << ", \"p99_ms\": " << result.p99;
+    out << ", \"max_ms\": " << result.longest;
+    out << ", \"peak_rss_kb\": " << result.peakRss;
+    out << ", \"allocations\": " << result.allocations;
+    out << ", \"allocated_bytes\": " << result.allocatedBytes;
+    out << ", \"hash\": \"" << std::hex << result.hash << std::dec << "\"}";
+    out << ((r + 1 < results.size()) ? ",\n" : "\n");
+  }
+
+  out << "  ]\n";
+  out << "}\n";
+}
+
+bool find_value(std::string &json, std::string scene, std::string key, std::string &value)
+{
+  //Enough of a reader for files this program wrote
+  size_t start = json.find("\"name\": \"" + scene + "\"");
+
+  if(start == std::string::npos)
+  {
+    return false;
+  }
+
+  size_t end = json.find("}", start);
+  size_t at = json.find("\"" + key + "\": ", start);
+
+  if((at == std::string::npos) || (at > end))
+  {
+    return false;
+  }
+
+  at += key.size() + 4;
+  size_t stop = json.find_first_of(",}", at);
+  value = json.substr(at, stop - at);
+
+  //Strip quotes from strings
+  if((value.size() >= 2) && (value[0] == '"'))
+  {
+    value = value.substr(1, value.size() - 2);
+  }
+
+  return true;
+}
+
+bool compare_baseline(std::string filename, std::vector<SceneResult> &results)
+{
+  std::ifstream file(filename.c_str());
+
+  if(file == NULL)
+  {
+    std::cerr << "No baseline at " << filename << std::endl;
+    return false;
+  }
+
+  std::stringstream contents;
+  contents << file.rdbuf();
+  std::string json = contents.str();
+
+  bool passed = true;
+
+  for(unsigned int r = 0; r < results.size(); r++)
+  {
+    SceneResult &result = results[r];
+    std::string fps, p95, allocs, hash;
+
+    if((find_value(json, result.name, "fps", fps) == false) ||
+       (find_value(json, result.name, "p95_ms", p95) == false) ||
+       (find_value(json, result.name, "allocations", allocs) == false) ||
+       (find_value(json, result.name, "hash", hash) == false))
+    {
+      std::cout << result.name << ": not in baseline" << std::endl;
+      continue;
+    }
+
+    double limit = REGRESSION_PERCENT / 100.0;
+    double baseFps = atof(fps.c_str());
+    double baseP95 = atof(p95.c_str());
+    Uint64 baseAllocs = strtoull(allocs.c_str(), NULL, 10);
+
+    if(result.fps < baseFps * (1.0 - limit))
+    {
+      std::cout << result.name << ": REGRESSION fps " << baseFps << " -> " << result.fps << std::endl;
+      passed = false;
+    }
+
+    if(result.p95 > baseP95 * (1.0 + limit))
+    {
+      std::cout << result.name << ": REGRESSION p95 " << baseP95 << " -> " << result.p95 << " ms" << std::endl;
+      passed = false;
+    }
+
+    if(result.allocations > baseAllocs)
+    {
+      std::cout << result.name << ": REGRESSION allocations " << baseAllocs << " -> " << result.allocations << std::endl;
+      passed = false;
+    }
+
+    //Not a failure, but timings of a different picture mean little
+    std::stringstream current;
+    current << std::hex << result.hash;
+
+    if(current.str() != hash)
+    {
+      std::cout << result.name << ": output changed, hash " << hash << " -> " << current.str() << std::endl;
+    }
+  }
+
+  return passed;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Benchmarks never need a display; keep a driver picked from outside
+  if(getenv("SDL_VIDEODRIVER") == NULL)
+  {
+    putenv((char *)"SDL_VIDEODRIVER=dummy");
+  }
+
+  if(SDL_Init(SDL_INIT_VIDEO) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Scene Bench", NULL);
+
+  return true;
+}
+
+void clean_up()
+{
+  SDL_FreeSurface(dot);
+  SDL_FreeSurface(level);
+  SDL_FreeSurface(tileSheet);
+  SDL_FreeSurface(foo);
+  SDL_FreeSurface(red);
+  SDL_FreeSurface(green);
+  SDL_FreeSurface(blue);
+  SDL_FreeSurface(shimmer);
+
+  SDL_Quit();
+}
+
+Dot::Dot()
+{
+  x = 0;
+  y = 0;
+  xVel = 0;
+  yVel = 0;
+  width = SCREEN_WIDTH;
+  height = SCREEN_HEIGHT;
+}
+
+void Dot::reset(int areaWidth, int areaHeight)
+{
+  x = 0;
+  y = 0;
+  xVel = 0;
+  yVel = 0;
+  width = areaWidth;
+  height = areaHeight;
+}
+
+void Dot::handle_input()
+{
+  if(event.type == SDL_KEYDOWN)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel += DOT_WIDTH / 2; break;
+      case SDLK_LEFT: xVel -= DOT_WIDTH / 2; break;
+    }
+  }
+  else if(event.type == SDL_KEYUP)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel -= DOT_WIDTH / 2; break;
+      case SDLK_LEFT: xVel += DOT_WIDTH / 2; break;
+    }
+  }
+}
+
+void Dot::move()
+{
+  x += xVel;
+
+  if((x < 0) || (x + DOT_WIDTH > width))
+  {
+    x -= xVel;
+  }
+
+  y += yVel;
+
+  if((y < 0) || (y + DOT_HEIGHT > height))
+  {
+    y -= yVel;
+  }
+}
+
+void Dot::set_camera()
+{
+  camera.x = (x + DOT_WIDTH / 2) - SCREEN_WIDTH / 2;
+  camera.y = (y + DOT_HEIGHT / 2) - SCREEN_HEIGHT / 2;
+
+  if(camera.x < 0)
+  {
+    camera.x = 0;
+  }
+  if(camera.y < 0)
+  {
+    camera.y = 0;
+  }
+  if(camera.x > LEVEL_WIDTH - camera.w)
+  {
+    camera.x = LEVEL_WIDTH - camera.w;
+  }
+  if(camera.y > LEVEL_HEIGHT - camera.h)
+  {
+    camera.y = LEVEL_HEIGHT - camera.h;
+  }
+}
+
+int Dot::get_x()
+{
+  return x;
+}
+
+int Dot::get_y()
+{
+  return y;
+}
+
+Foo::Foo()
+{
+  offSet = 0;
+  velocity = 0;
+  frame = 0;
+  status = 0;
+}
+
+void Foo::handle_input()
+{
+  if(event.type == SDL_KEYDOWN)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_RIGHT: velocity += FOO_WIDTH / 4; break;
+      case SDLK_LEFT: velocity -= FOO_WIDTH / 4; break;
+    }
+  }
+  else if(event.type == SDL_KEYUP)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_RIGHT: velocity -= FOO_WIDTH / 4; break;
+      case SDLK_LEFT: velocity += FOO_WIDTH / 4; break;
+    }
+  }
+}
+
+void Foo::move()
+{
+  offSet += velocity;
+
+  if((offSet < 0) || (offSet + FOO_WIDTH > SCREEN_WIDTH))
+  {
+    offSet -= velocity;
+  }
+}
+
+void Foo::show()
+{
+  //Row 0 of the sheet walks right, row 1 walks left
+  if(velocity < 0)
+  {
+    status = 1;
+    frame++;
+  }
+  else if(velocity > 0)
+  {
+    status = 0;
+    frame++;
+  }
+  else
+  {
+    frame = 0;
+  }
+
+  if(frame >= 4)
+  {
+    frame = 0;
+  }
+
+  apply_surface(offSet, SCREEN_HEIGHT - FOO_HEIGHT, foo, screen, &fooClips[status][frame]);
+}
+
+bool load_dot()
+{
+  if(dot == NULL)
+  {
+    dot = load_image("dot.bmp");
+  }
+
+  return dot != NULL;
+}
+
+bool load_particles()
+{
+  if(red == NULL)
+  {
+    red = load_image("red.bmp");
+    green = load_image("green.bmp");
+    blue = load_image("blue.bmp");
+    shimmer = load_image("shimmer.bmp");
+
+    if((red == NULL) || (green == NULL) || (blue == NULL) || (shimmer == NULL))
+    {
+      return false;
+    }
+
+    SDL_SetAlpha(red, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+    SDL_SetAlpha(blue, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+    SDL_SetAlpha(green, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+    SDL_SetAlpha(shimmer, SDL_SRCALPHA | SDL_RLEACCEL, 192);
+  }
+
+  return load_dot();
+}
+
+void reset_particles()
+{
+  player.reset(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    particles[p].frame = 11;
+  }
+}
+
+void handle_dot()
+{
+  player.handle_input();
+}
+
+void render_particles()
+{
+  player.move();
+
+  SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+  apply_surface(player.get_x(), player.get_y(), dot, screen);
+
+  //Same rules as the particle engine lesson
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    if(particles[p].frame > 10)
+    {
+      particles[p].x = player.get_x() - 5 + (rand() % 25);
+      particles[p].y = player.get_y() - 5 + (rand() % 25);
+      particles[p].frame = rand() % 5;
+
+      switch(rand() % 3)
+      {
+        case 0: particles[p].type = red; break;
+        case 1: particles[p].type = green; break;
+        case 2: particles[p].type = blue; break;
+      }
+    }
+
+    apply_surface(particles[p].x, particles[p].y, particles[p].type, screen);
+
+    if(particles[p].frame % 2 == 0)
+    {
+      apply_surface(particles[p].x, particles[p].y, shimmer, screen);
+    }
+
+    particles[p].frame++;
+  }
+}
+
+bool load_scrolling()
+{
+  if(level == NULL)
+  {
+    level = load_image("bg.png");
+  }
+
+  return (level != NULL) && (load_dot() == true);
+}
+
+void reset_level_dot()
+{
+  player.reset(LEVEL_WIDTH, LEVEL_HEIGHT);
+}
+
+void render_scrolling()
+{
+  player.move();
+  player.set_camera();
+
+  SDL_Rect view = camera;
+  apply_surface(0, 0, level, screen, &view);
+  apply_surface(player.get_x() - camera.x, player.get_y() - camera.y, dot, screen);
+}
+
+bool load_tiling()
+{
+  if(tileSheet == NULL)
+  {
+    tileSheet = load_image("tiles.png");
+  }
+
+  if((tileSheet == NULL) || (load_dot() == false))
+  {
+    return false;
+  }
+
+  //Sheet columns: plain colours, then left, middle and right edge pieces
+  const int sheetColumn[TILE_SPRITES] = {0, 0, 0, 2, 2, 3, 3, 3, 2, 1, 1, 1};
+  const int sheetRow[TILE_SPRITES] = {0, 1, 2, 1, 0, 0, 1, 2, 2, 2, 1, 0};
+
+  for(int t = 0; t < TILE_SPRITES; t++)
+  {
+    tileClips[t].x = sheetColumn[t] * TILE_WIDTH;
+    tileClips[t].y = sheetRow[t] * TILE_HEIGHT;
+    tileClips[t].w = TILE_WIDTH;
+    tileClips[t].h = TILE_HEIGHT;
+  }
+
+  std::ifstream map("lazy.map");
+
+  if(map == NULL)
+  {
+    return false;
+  }
+
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    int tileType = -1;
+    map >> tileType;
+
+    if((map.fail() == true) || (tileType < 0) || (tileType >= TILE_SPRITES))
+    {
+      return false;
+    }
+
+    tileTypes[t] = tileType;
+  }
+
+  return true;
+}
+
+void render_tiling()
+{
+  player.move();
+  player.set_camera();
+
+  for(int t = 0; t < TOTAL_TILES; t++)
+  {
+    int tileX = (t % (LEVEL_WIDTH / TILE_WIDTH)) * TILE_WIDTH;
+    int tileY = (t / (LEVEL_WIDTH / TILE_WIDTH)) * TILE_HEIGHT;
+
+    //Only what the camera sees
+    if((tileX + TILE_WIDTH <= camera.x) || (tileX >= camera.x + camera.w))
+    {
+      continue;
+    }
+
+    if((tileY + TILE_HEIGHT <= camera.y) || (tileY >= camera.y + camera.h))
+    {
+      continue;
+    }
+
+    apply_surface(tileX - camera.x, tileY - camera.y, tileSheet, screen, &tileClips[tileTypes[t]]);
+  }
+
+  apply_surface(player.get_x() - camera.x, player.get_y() - camera.y, dot, screen);
+}
+
+bool load_animation()
+{
+  if(foo == NULL)
+  {
+    foo = load_image("foo.png");
+  }
+
+  for(int row = 0; row < 2; row++)
+  {
+    for(int f = 0; f < 4; f++)
+    {
+      fooClips[row][f].x = FOO_WIDTH * f;
+      fooClips[row][f].y = FOO_HEIGHT * row;
+      fooClips[row][f].w = FOO_WIDTH;
+      fooClips[row][f].h = FOO_HEIGHT;
+    }
+  }
+
+  return foo != NULL;
+}
+
+void reset_animation()
+{
+  walker = Foo();
+}
+
+void handle_foo()
+{
+  walker.handle_input();
+}
+
+void render_animation()
+{
+  walker.move();
+
+  SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+  walker.show();
+}
@@ -0,0 +1,587 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+
+//Particle engine drawn from atlases built by atlas_packer:
+//  atlas_packer sprites dot.bmp
+//  atlas_packer particles red.bmp green.bmp blue.bmp shimmer.bmp
+//Per surface alpha applies to a whole page, so sprites that blend differently
+//go in different atlases.
+
+//Constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+const int FRAMES_PER_SECOND = 20;
+const int DOT_WIDTH = 20;
+const int DOT_HEIGHT = 20;
+const int TOTAL_PARTICLES = 20;
+const int ATLAS_VERSION = 1;
+
+//Structs/Classes
+struct AtlasSprite
+{
+  std::string name;
+  int page;
+  SDL_Rect clip;
+};
+
+class TextureAtlas
+{
+  private:
+    std::vector<SDL_Surface *> pages;
+    std::vector<AtlasSprite> sprites;
+
+  public:
+    TextureAtlas();
+    ~TextureAtlas();
+    bool load(std::string filename);
+    void set_alpha(Uint8 alpha);
+    int find(std::string name);
+    SDL_Surface *get_page(int sprite);
+    SDL_Rect *get_clip(int sprite);
+    void show(int x, int y, int sprite, SDL_Surface *destination);
+    void free();
+};
+
+class Particle
+{
+  private:
+    int x, y;
+    int frame;
+
+    int type;
+
+  public:
+    Particle(int X, int Y);
+    void show();
+    bool is_dead();
+};
+
+class Dot
+{
+  private:
+    int x, y;
+    int xVel, yVel;
+    Particle *particles[TOTAL_PARTICLES];
+
+  public:
+    Dot();
+    ~Dot();
+    void handle_input();
+    void move();
+    void show();
+    void show_particles();
+};
+
+class Timer
+{
+  private:
+    int startTicks;
+    int pausedTicks;
+
+    bool paused;
+    bool started;
+
+  public:
+    Timer();
+    void start();
+    void stop();
+    void pause();
+    void unpause();
+    int get_ticks();
+    bool is_started();
+    bool is_paused();
+};
+
+//Globals
+SDL_Surface *screen = NULL;
+SDL_Event event;
+
+TextureAtlas sprites;
+TextureAtlas particleSprites;
+
+//Sprite ids, looked up by name once after loading
+int dot = -1;
+int red = -1;
+int green = -1;
+int blue = -1;
+int shimmer = -1;
+
+//Prototypes
+bool init();
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL);
+SDL_Surface *load_image(std::string filename);
+bool load_files();
+void clean_up();
+bool sprite_less(const AtlasSprite &A, const AtlasSprite &B);
+
+//Functions
+int main(int argc, char* args[])
+{
+  Timer fps;
+  bool quit = false;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  Dot myDot;
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    fps.start();
+
+    while(SDL_PollEvent(&event))
+    {
+      myDot.handle_input();
+
+      if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    myDot.move();
+    SDL_FillRect(screen, &screen->clip_rect, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
+    myDot.show();
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    if(fps.get_ticks() < 1000 / FRAMES_PER_SECOND)
+    {
+      SDL_Delay((1000 / FRAMES_PER_SECOND) - fps.get_ticks());
+    }
+  }
+
+  clean_up();
+  return 0;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Texture Atlas", NULL);
+
+  srand(SDL_GetTicks());
+
+  return true;
+}
+
+bool load_files()
+{
+  if((sprites.load("sprites.atlas") == false) || (particleSprites.load("particles.atlas") == false))
+  {
+    return false;
+  }
+
+  particleSprites.set_alpha(192);
+
+  dot = sprites.find("dot");
+  red = particleSprites.find("red");
+  green = particleSprites.find("green");
+  blue = particleSprites.find("blue");
+  shimmer = particleSprites.find("shimmer");
+
+  if((dot == -1) || (red == -1) || (green == -1) || (blue == -1) || (shimmer == -1))
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  sprites.free();
+  particleSprites.free();
+
+  SDL_Quit();
+}
+
+bool sprite_less(const AtlasSprite &A, const AtlasSprite &B)
+{
+  return A.name < B.name;
+}
+
+TextureAtlas::TextureAtlas()
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+  free();
+}
+
+bool TextureAtlas::load(std::string filename)
+{
+  std::ifstream index(filename.c_str());
+  std::string magic;
+  int version = 0, pageCount = 0, spriteCount = 0;
+
+  if(index == NULL)
+  {
+    return false;
+  }
+
+  index >> magic >> version >> pageCount >> spriteCount;
+
+  if((index.fail() == true) || (magic != "ATLAS") || (version != ATLAS_VERSION))
+  {
+    return false;
+  }
+
+  for(int p = 0; p < pageCount; p++)
+  {
+    std::string pageFile;
+    index >> pageFile;
+
+    SDL_Surface *page = load_image(pageFile);
+
+    if((index.fail() == true) || (page == NULL))
+    {
+      return false;
+    }
+
+    pages.push_back(page);
+  }
+
+  for(int s = 0; s < spriteCount; s++)
+  {
+    AtlasSprite sprite;
+    int x = 0, y = 0, w = 0, h = 0;
+
+    index >> sprite.name >> sprite.page >> x >> y >> w >> h;
+
+    if((index.fail() == true) || (sprite.page < 0) || (sprite.page >= pageCount))
+    {
+      return false;
+    }
+
+    sprite.clip.x = x;
+    sprite.clip.y = y;
+    sprite.clip.w = w;
+    sprite.clip.h = h;
+    sprites.push_back(sprite);
+  }
+
+  //The packer writes them sorted already, but find() depends on it
+  std::sort(sprites.begin(), sprites.end(), sprite_less);
+
+  index.close();
+  return true;
+}
+
+void TextureAtlas::set_alpha(Uint8 alpha)
+{
+  for(unsigned int p = 0; p < pages.size(); p++)
+  {
+    SDL_SetAlpha(pages[p], SDL_SRCALPHA | SDL_RLEACCEL, alpha);
+  }
+}
+
+int TextureAtlas::find(std::string name)
+{
+  //Binary search by name; keep the id instead of calling this per frame
+  AtlasSprite key;
+  key.name = name;
+
+  std::vector<AtlasSprite>::iterator found = std::lower_bound(sprites.begin(), sprites.end(), key, sprite_less);
+
+  if((found == sprites.end()) || (found->name != name))
+  {
+    return -1;
+  }
+
+  return found - sprites.begin();
+}
+
+SDL_Surface *TextureAtlas::get_page(int sprite)
+{
+  return pages[sprites[sprite].page];
+}
+
+SDL_Rect *TextureAtlas::get_clip(int sprite)
+{
+  return &sprites[sprite].clip;
+}
+
+void TextureAtlas::show(int x, int y, int sprite, SDL_Surface *destination)
+{
+  apply_surface(x, y, get_page(sprite), destination, get_clip(sprite));
+}
+
+void TextureAtlas::free()
+{
+  for(unsigned int p = 0; p < pages.size(); p++)
+  {
+    SDL_FreeSurface(pages[p]);
+  }
+
+  pages.clear();
+  sprites.clear();
+}
+
+Timer::Timer()
+{
+  startTicks = 0;
+  pausedTicks = 0;
+  paused = false;
+  started = false;
+}
+
+void Timer::start()
+{
+  started = true;
+  paused = false;
+  startTicks = SDL_GetTicks();
+}
+
+void Timer::stop()
+{
+  started = false;
+  paused = false;
+}
+
+int Timer::get_ticks()
+{
+  if(started == true)
+  {
+    if(paused == true)
+    {
+      return pausedTicks;
+    }
+    else
+    {
+      return SDL_GetTicks() - startTicks;
+    }
+  }
+  return 0;
+}
+
+void Timer::pause()
+{
+  if((started == true) && (paused == false))
+  {
+    paused = true;
+    pausedTicks = SDL_GetTicks() - startTicks;
+  }
+}
+
+void Timer::unpause()
+{
+  if(paused == true)
+  {
+    paused = false;
+    startTicks = SDL_GetTicks() - pausedTicks;
+    pausedTicks = 0;
+  }
+}
+
+bool Timer::is_started()
+{
+  return started;
+}
+
+bool Timer::is_paused()
+{
+  return paused;
+}
+
+Dot::Dot()
+{
+  x = 0;
+  y = 0;
+  xVel = 0;
+  yVel = 0;
+
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    particles[p] = new Particle(x, y);
+  }
+}
+
+Dot::~Dot()
+{
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    delete particles[p];
+  }
+}
+
+void Dot::handle_input()
+{
+  if(event.type == SDL_KEYDOWN)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel += DOT_WIDTH/ 2; break;
+      case SDLK_LEFT: xVel -= DOT_WIDTH/ 2; break;
+    }
+  }
+  else if(event.type == SDL_KEYUP)
+  {
+    switch(event.key.keysym.sym)
+    {
+      case SDLK_UP: yVel += DOT_HEIGHT / 2; break;
+      case SDLK_DOWN: yVel -= DOT_HEIGHT / 2; break;
+      case SDLK_RIGHT: xVel -= DOT_WIDTH/ 2; break;
+      case SDLK_LEFT: xVel += DOT_WIDTH/ 2; break;
+    }
+  }
+}
+
+void Dot::move()
+{
+  x += xVel;
+
+  if((x < 0) || (x + DOT_WIDTH > SCREEN_WIDTH))
+  {
+    x -= xVel;
+  }
+
+  y += yVel;
+
+  if((y < 0) || (y + DOT_HEIGHT > SCREEN_HEIGHT))
+  {
+    y -= yVel;
+  }
+}
+
+void Dot::show()
+{
+  sprites.show(x, y, dot, screen);
+  show_particles();
+}
+
+void Dot::show_particles()
+{
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    if(particles[p]->is_dead() == true)
+    {
+      delete particles[p];
+      particles[p] = new Particle(x, y);
+    }
+  }
+
+  for(int p = 0; p < TOTAL_PARTICLES; p++)
+  {
+    particles[p]->show();
+  }
+}
+
+Particle::Particle(int X, int Y)
+{
+  x = X - 5 + (rand() % 25);
+  y = Y - 5 + (rand() % 25);
+
+  frame = rand() % 5;
+
+  switch(rand() % 3)
+  {
+    case 0: type = red; break;
+    case 1: type = green; break;
+    case 2: type = blue; break;
+  }
+}
+
+void Particle::show()
+{
+  //Type and shimmer share a page, so no surface switch between the two blits
+  particleSprites.show(x, y, type, screen);
+
+  if(frame % 2 == 0)
+  {
+    particleSprites.show(x, y, shimmer, screen);
+  }
+
+  frame++;
+}
+
+bool Particle::is_dead()
+{
+  if(frame > 10)
+  {
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,684 @@
+#include "iostream"
+#include "SDL/SDL.h"
+#include "SDL/SDL_image.h"
+#include "SDL/SDL_ttf.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+//The advanced timing lesson with a scheduler for delayed and periodic
+//events instead of more get_ticks() checks in the loop. TimerWheel is a
+//hierarchical timing wheel: four levels of 256 slots, each level 256 times
+//coarser than the one below. Scheduling and cancelling are O(1) linked list
+//operations and a tick only looks at one slot, however many timers are
+//pending. The wheel reads time from a Timer, so pausing that Timer pauses
+//every scheduled event. T schedules a million random timers, C cancels them.
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int SCREEN_BPP = 32;
+
+//Milliseconds per wheel tick
+const int WHEEL_RESOLUTION = 10;
+
+const int WHEEL_LEVELS = 4;
+const int WHEEL_BITS = 8;
+const int WHEEL_SLOTS = 1 << WHEEL_BITS;
+const int WHEEL_MASK = WHEEL_SLOTS - 1;
+
+//The list holding the batch being fired
+const int DUE_LIST = WHEEL_LEVELS * WHEEL_SLOTS;
+
+const int STRESS_TIMERS = 1000000;
+
+SDL_Surface *background = NULL;
+SDL_Surface *screen = NULL;
+SDL_Surface *seconds = NULL;
+SDL_Surface *startStop = NULL;
+SDL_Surface *pauseMessage = NULL;
+SDL_Surface *blinkMessage = NULL;
+
+SDL_Event event;
+TTF_Font *font = NULL;
+SDL_Color textColor = {0, 0, 0};
+
+typedef void (*TimerCallback)(void *data);
+
+//Slot index in the low half, reuse count in the high half, 0 is never valid
+typedef Uint64 TimerHandle;
+
+class Timer
+{
+  private:
+    int startTicks;
+    int pausedTicks;
+
+    bool paused;
+    bool started;
+
+  public:
+    Timer();
+    void start();
+    void stop();
+    void pause();
+    void unpause();
+    int get_ticks();
+    bool is_started();
+    bool is_paused();
+};
+
+struct TimerNode
+{
+  Uint32 expires;
+  Uint32 period;
+  Uint32 generation;
+  int list;
+  int prev, next;
+  TimerCallback callback;
+  void *data;
+};
+
+class TimerWheel
+{
+  private:
+    std::vector<TimerNode> nodes;
+    std::vector<int> heads;
+    int freeNodes;
+    int pending;
+    int fired;
+
+    Timer *clock;
+    int lastTicks;
+    int elapsed;
+    Uint32 now;
+
+    int allocate();
+    void release(int node);
+    void link(int node, int list);
+    void unlink(int node);
+    void place(int node);
+    void cascade(int level);
+    void tick();
+
+  public:
+    TimerWheel(Timer *source);
+    TimerHandle schedule(Uint32 delay, TimerCallback callback, void *data, Uint32 period = 0);
+    bool cancel(TimerHandle handle);
+    void update();
+    int get_pending();
+    int take_fired();
+};
+
+Timer::Timer()
+{
+  startTicks = 0;
+  pausedTicks = 0;
+  paused = false;
+  started = false;
+}
+
+void Timer::start()
+{
+  started = true;
+  paused = false;
+  startTicks = SDL_GetTicks();
+}
+
+void Timer::stop()
+{
+  started = false;
+  paused = false;
+}
+
+int Timer::get_ticks()
+{
+  if(started == true)
+  {
+    if(paused == true)
+    {
+      return pausedTicks;
+    }
+    else
+    {
+      return SDL_GetTicks() - startTicks;
+    }
+  }
+  return 0;
+}
+
+void Timer::pause()
+{
+  if((started == true) && (paused == false))
+  {
+    paused = true;
+    pausedTicks = SDL_GetTicks() - startTicks;
+  }
+}
+
+void Timer::unpause()
+{
+  if(paused == true)
+  {
+    paused = false;
+    startTicks = SDL_GetTicks() - pausedTicks;
+    pausedTicks = 0;
+  }
+}
+
+bool Timer::is_started()
+{
+  return started;
+}
+
+bool Timer::is_paused()
+{
+  return paused;
+}
+
+TimerWheel::TimerWheel(Timer *source)
+{
+  heads.resize(DUE_LIST + 1, -1);
+  freeNodes = -1;
+  pending = 0;
+  fired = 0;
+
+  clock = source;
+  lastTicks = clock->get_ticks();
+  elapsed = 0;
+  now = 0;
+}
+
+int TimerWheel::allocate()
+{
+  int node = freeNodes;
+
+  if(node == -1)
+  {
+    TimerNode fresh;
+    fresh.generation = 1;
+    nodes.push_back(fresh);
+    node = nodes.size() - 1;
+  }
+  else
+  {
+    freeNodes = nodes[node].next;
+  }
+
+  nodes[node].list = -1;
+  nodes[node].prev = -1;
+  nodes[node].next = -1;
+  pending++;
+
+  return node;
+}
+
+void TimerWheel::release(int node)
+{
+  //Old handles to this node stop matching
+  nodes[node].generation++;
+
+  if(nodes[node].generation == 0)
+  {
+    nodes[node].generation = 1;
+  }
+
+  nodes[node].list = -1;
+  nodes[node].next = freeNodes;
+  freeNodes = node;
+  pending--;
+}
+
+void TimerWheel::link(int node, int list)
+{
+  nodes[node].list = list;
+  nodes[node].prev = -1;
+  nodes[node].next = heads[list];
+
+  if(heads[list] != -1)
+  {
+    nodes[heads[list]].prev = node;
+  }
+
+  heads[list] = node;
+}
+
+void TimerWheel::unlink(int node)
+{
+  TimerNode &timer = nodes[node];
+
+  if(timer.prev != -1)
+  {
+    nodes[timer.prev].next = timer.next;
+  }
+  else
+  {
+    heads[timer.list] = timer.next;
+  }
+
+  if(timer.next != -1)
+  {
+    nodes[timer.next].prev = timer.prev;
+  }
+
+  timer.list = -1;
+}
+
+void TimerWheel::place(int node)
+{
+  Uint32 expires = nodes[node].expires;
+  Uint32 delta = expires - now;
+
+  //Timers due this tick only arrive here by cascading, before the current
+  //slot is fired, so they can stay in it. Overdue ones go in the next slot.
+  if((Sint32)delta < 0)
+  {
+    expires = now + 1;
+    delta = 1;
+  }
+
+  //The level is picked by how far away the timer is
+  int level = 0;
+
+  while((level < WHEEL_LEVELS - 1) && (delta >= (Uint32)1 << (WHEEL_BITS * (level + 1))))
+  {
+    level++;
+  }
+
+  int slot = (expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+  link(node, level * WHEEL_SLOTS + slot);
+}
+
+void TimerWheel::cascade(int level)
+{
+  //Redistribute one coarse slot into the finer levels below it
+  int list = level * WHEEL_SLOTS + ((now >> (WHEEL_BITS * level)) & WHEEL_MASK);
+  int node = heads[list];
+  heads[list] = -1;
+
+  while(node != -1)
+  {
+    int next = nodes[node].next;
+    place(node);
+    node = next;
+  }
+}
+
+void TimerWheel::tick()
+{
+  now++;
+
+  //When a level wraps, pull the next slot of the level above down
+  for(int level = 1; level < WHEEL_LEVELS; level++)
+  {
+    if(((now >> (WHEEL_BITS * (level - 1))) & WHEEL_MASK) != 0)
+    {
+      break;
+    }
+
+    cascade(level);
+  }
+
+  //Move the whole slot out as one batch before calling anything, so
+  //callbacks can schedule and cancel freely
+  int list = now & WHEEL_MASK;
+  heads[DUE_LIST] = heads[list];
+  heads[list] = -1;
+
+  for(int node = heads[DUE_LIST]; node != -1; node = nodes[node].next)
+  {
+    nodes[node].list = DUE_LIST;
+  }
+
+  while(heads[DUE_LIST] != -1)
+  {
+    int node = heads[DUE_LIST];
+    unlink(node);
+
+    TimerCallback callback = nodes[node].callback;
+    void *data = nodes[node].data;
+
+    if(nodes[node].period > 0)
+    {
+      nodes[node].expires += nodes[node].period;
+      place(node);
+    }
+    else
+    {
+      release(node);
+    }
+
+    callback(data);
+    fired++;
+  }
+}
+
+TimerHandle TimerWheel::schedule(Uint32 delay, TimerCallback callback, void *data, Uint32 period)
+{
+  int node = allocate();
+
+  //Round up from the time already banked so a timer never fires early
+  Uint32 ticks = (elapsed + delay + WHEEL_RESOLUTION - 1) / WHEEL_RESOLUTION;
+
+  if(ticks == 0)
+  {
+    ticks = 1;
+  }
+
+  nodes[node].expires = now + ticks;
+  nodes[node].period = (period + WHEEL_RESOLUTION - 1) / WHEEL_RESOLUTION;
+  nodes[node].callback = callback;
+  nodes[node].data = data;
+
+  place(node);
+
+  return ((TimerHandle)nodes[node].generation << 32) | (Uint32)node;
+}
+
+bool TimerWheel::cancel(TimerHandle handle)
+{
+  int node = (int)(handle & 0xFFFFFFFF);
+  Uint32 generation = (Uint32)(handle >> 32);
+
+  if((node < 0) || (node >= (int)nodes.size()))
+  {
+    return false;
+  }
+
+  //Fired, cancelled or reused since the handle was made
+  if((nodes[node].generation != generation) || (nodes[node].list == -1))
+  {
+    return false;
+  }
+
+  unlink(node);
+  release(node);
+
+  return true;
+}
+
+void TimerWheel::update()
+{
+  int ticks = clock->get_ticks();
+
+  //A stopped or restarted Timer counts from zero again; only ever go forward.
+  //A paused Timer returns the same ticks, so nothing moves.
+  if(ticks >= lastTicks)
+  {
+    elapsed += ticks - lastTicks;
+  }
+
+  lastTicks = ticks;
+
+  while(elapsed >= WHEEL_RESOLUTION)
+  {
+    elapsed -= WHEEL_RESOLUTION;
+    tick();
+  }
+}
+
+int TimerWheel::get_pending()
+{
+  return pending;
+}
+
+int TimerWheel::take_fired()
+{
+  int count = fired;
+  fired = 0;
+
+  return count;
+}
+
+void apply_surface(int x, int y, SDL_Surface *source, SDL_Surface *destination, SDL_Rect *clip = NULL)
+{
+  //Make a temporary rectangle to hold the offsets
+  SDL_Rect offset;
+
+  //Give the offsets to the rectangle
+  offset.x = x;
+  offset.y = y;
+
+  //Blit the surface
+  SDL_BlitSurface(source, clip, destination, &offset);
+}
+
+SDL_Surface *load_image(std::string filename)
+{
+  //Temporary storage for the image that's loaded
+  SDL_Surface *loadedImage = NULL;
+
+  //Optimized image that will be used
+  SDL_Surface *optimizedImage = NULL;
+
+  //Load the image
+  loadedImage = IMG_Load(filename.c_str());
+
+  //If nothing went wrong in loading the image
+  if(loadedImage != NULL)
+  {
+    //Create an optimized image
+    optimizedImage = SDL_DisplayFormat(loadedImage);
+
+    //Free the old image
+    SDL_FreeSurface(loadedImage);
+  }
+
+  //If the image was optimized without error
+  if(optimizedImage != NULL)
+  {
+    //Map the color key
+    Uint32 colorkey = SDL_MapRGB(optimizedImage->format, 0, 0xFF, 0xFF);
+
+    //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
+    SDL_SetColorKey(optimizedImage, SDL_SRCCOLORKEY, colorkey);
+  }
+
+  //Return the optimized image
+  return optimizedImage;
+}
+
+bool init()
+{
+  //Init SDL subsystems
+  if(SDL_Init(SDL_INIT_EVERYTHING) == -1)
+  {
+    return false;
+  }
+
+  //Set up screen
+  screen = SDL_SetVideoMode(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_BPP, SDL_SWSURFACE);
+
+  //If there was an error setting up the screen
+  if(screen == NULL)
+  {
+    return false;
+  }
+
+  if(TTF_Init() == -1)
+  {
+    return false;
+  }
+
+  SDL_WM_SetCaption("Timer Wheel", NULL);
+
+  return true;
+}
+
+bool load_files()
+{
+  //Load image
+  background = load_image("background.png");
+
+  //Open the font
+  font = TTF_OpenFont("lazy.ttf", 30);
+
+  //If there was an error loading the images
+  if(background == NULL)
+  {
+    return false;
+  }
+
+  if(font == NULL)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void clean_up()
+{
+  //Free the images
+  SDL_FreeSurface(background);
+  SDL_FreeSurface(startStop);
+  SDL_FreeSurface(pauseMessage);
+  SDL_FreeSurface(blinkMessage);
+
+  TTF_CloseFont(font);
+
+  TTF_Quit();
+  SDL_Quit();
+}
+
+void toggle(void *data)
+{
+  bool *flag = (bool *)data;
+  *flag = (!*flag);
+}
+
+void count(void *data)
+{
+  int *counter = (int *)data;
+  (*counter)++;
+}
+
+int main(int argc, char* args[])
+{
+  bool quit = false;
+  bool blink = false;
+  int stressFired = 0;
+  int wheelTicks = 0;
+  Uint32 update = 0;
+  std::vector<TimerHandle> stress;
+
+  if(init() == false)
+  {
+    return 1;
+  }
+
+  //Load the files
+  if(load_files() == false)
+  {
+    return 1;
+  }
+
+  Timer myTimer;
+  TimerWheel events(&myTimer);
+
+  startStop = TTF_RenderText_Solid(font, "Press S to start or stop the timer", textColor);
+  pauseMessage = TTF_RenderText_Solid(font, "Press P to pause or unpause the timer", textColor);
+  blinkMessage = TTF_RenderText_Solid(font, "Scheduled every 500 ms", textColor);
+
+  myTimer.start();
+
+  //Periodic event instead of a get_ticks() check in the loop
+  events.schedule(500, toggle, &blink, 500);
+
+  update = SDL_GetTicks();
+
+  //While user hasn't quit
+  while(quit == false)
+  {
+    while(SDL_PollEvent(&event))
+    {
+      if(event.type == SDL_KEYDOWN)
+      {
+        if(event.key.keysym.sym == SDLK_s)
+        {
+          if(myTimer.is_started() == true)
+          {
+            myTimer.stop();
+          }
+          else
+          {
+            myTimer.start();
+          }
+        }
+        if(event.key.keysym.sym == SDLK_p)
+        {
+          if(myTimer.is_paused() == true)
+          {
+            myTimer.unpause();
+          }
+          else
+          {
+            myTimer.pause();
+          }
+        }
+        if(event.key.keysym.sym == SDLK_t)
+        {
+          //Spread over the next minute
+          for(int t = 0; t < STRESS_TIMERS; t++)
+          {
+            stress.push_back(events.schedule(rand() % 60000, count, &stressFired));
+          }
+        }
+        if(event.key.keysym.sym == SDLK_c)
+        {
+          for(unsigned int t = 0; t < stress.size(); t++)
+          {
+            events.cancel(stress[t]);
+          }
+
+          stress.clear();
+        }
+      }
+      else if(event.type == SDL_QUIT)
+      {
+        quit = true;
+      }
+    }
+
+    Uint32 wheelStart = SDL_GetTicks();
+    events.update();
+    wheelTicks = SDL_GetTicks() - wheelStart;
+
+    apply_surface(0, 0, background, screen);
+    apply_surface((SCREEN_WIDTH - startStop->w) / 2, 200, startStop, screen);
+    apply_surface((SCREEN_WIDTH - pauseMessage->w) / 2, 300, pauseMessage, screen);
+
+    if(blink == true)
+    {
+      apply_surface((SCREEN_WIDTH - blinkMessage->w) / 2, 400, blinkMessage, screen);
+    }
+
+    std::stringstream time;
+    time << "Timer: " << myTimer.get_ticks() / 1000.f;
+
+    seconds = TTF_RenderText_Solid(font, time.str().c_str(), textColor);
+
+    apply_surface((SCREEN_WIDTH - seconds->w) / 2, 50, seconds, screen);
+
+    SDL_FreeSurface(seconds);
+
+    if(SDL_Flip(screen) == -1)
+    {
+      return 1;
+    }
+
+    if(SDL_GetTicks() - update > 1000)
+    {
+      std::stringstream caption;
+      caption << "Timer Wheel - " << events.get_pending() << " pending, ";
+      caption << events.take_fired() << " fired last second, ";
+      caption << stressFired << " stress timers done, last update " << wheelTicks << " ms";
+      SDL_WM_SetCaption(caption.str().c_str(), NULL);
+
+      update = SDL_GetTicks();
+    }
+  }
+
+  clean_up();
+  return 0;
+}
@@ -3,10 +3,13 @@
 #include "SDL/SDL_image.h"
 #include "SDL/SDL_ttf.h"
 #include <string>
+#include <algorithm>
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 const int SCREEN_BPP = 32;
+const int CARET_WIDTH = 12;
+const int CARET_BLINK = 500;
 
 SDL_Surface *background = NULL;
 SDL_Surface *screen = NULL;
@@ -15,6 +18,97 @@ SDL_Event event;
 TTF_Font *font = NULL;
 SDL_Color textColor = {255, 255, 255};
 
+//Nothing here moves on its own, so the loop sleeps in SDL_WaitEvent() and
+//only redraws what an event marked invalid. The blinking caret is the one
+//timed change and repaints just its own rectangle.
+class DirtyRect
+{
+  private:
+    SDL_Rect area;
+    bool dirty;
+
+  public:
+    DirtyRect();
+    void invalidate(SDL_Rect rect);
+    void invalidate_all();
+    bool is_dirty();
+    SDL_Rect get_area();
+    void clear();
+};
+
+DirtyRect::DirtyRect()
+{
+  dirty = false;
+  area.x = 0;
+  area.y = 0;
+  area.w = 0;
+  area.h = 0;
+}
+
+void DirtyRect::invalidate(SDL_Rect rect)
+{
+  //Keep it on the screen so it can go straight to SDL_UpdateRect()
+  int left = std::max((int)rect.x, 0);
+  int top = std::max((int)rect.y, 0);
+  int right = std::min(rect.x + rect.w, SCREEN_WIDTH);
+  int bottom = std::min(rect.y + rect.h, SCREEN_HEIGHT);
+
+  if((left >= right) || (top >= bottom))
+  {
+    return;
+  }
+
+  //Grow the area to cover both
+  if(dirty == true)
+  {
+    left = std::min(left, (int)area.x);
+    top = std::min(top, (int)area.y);
+    right = std::max(right, area.x + area.w);
+    bottom = std::max(bottom, area.y + area.h);
+  }
+
+  area.x = left;
+  area.y = top;
+  area.w = right - left;
+  area.h = bottom - top;
+  dirty = true;
+}
+
+void DirtyRect::invalidate_all()
+{
+  SDL_Rect all = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+  invalidate(all);
+}
+
+bool DirtyRect::is_dirty()
+{
+  return dirty;
+}
+
+SDL_Rect DirtyRect::get_area()
+{
+  return area;
+}
+
+void DirtyRect::clear()
+{
+  dirty = false;
+}
+
+Uint32 blink(Uint32 interval, void *param)
+{
+  //Timers run on their own thread, so just wake the main loop
+  SDL_Event user;
+  user.type = SDL_USEREVENT;
+  user.user.code = 0;
+  user.user.data1 = NULL;
+  user.user.data2 = NULL;
+
+  SDL_PushEvent(&user);
+
+  return interval;
+}
+
 SDL_Surface *load_image(std::string filename)
 {
   //Temporary storage for the image that's loaded
@@ -132,6 +226,8 @@ void clean_up()
 int main(int argc, char* args[])
 {
   bool quit = false;
+  bool caretOn = true;
+  DirtyRect dirty;
 
   if(init() == false)
   {
@@ -151,29 +247,70 @@ int main(int argc, char* args[])
     return 1;
   }
 
-  //Apply the surface to the screen
-  apply_surface(0, 0, background, screen);
-  apply_surface(0, 150, message, screen);
+  SDL_Rect caret;
+  caret.x = std::min(message->w + 4, SCREEN_WIDTH - CARET_WIDTH);
+  caret.y = 150;
+  caret.w = CARET_WIDTH;
+  caret.h = message->h;
 
-  //Update screen
-  if(SDL_Flip(screen) == -1)
-  {
-    return 1;
-  }
+  SDL_TimerID caretTimer = SDL_AddTimer(CARET_BLINK, blink, NULL);
+
+  //Everything needs drawing the first time
+  dirty.invalidate_all();
 
   //While user hasn't quit
   while(quit == false)
   {
-    while(SDL_PollEvent(&event))
+    if(dirty.is_dirty() == true)
     {
-      //If the user has Xed out the window
-      if(event.type == SDL_QUIT)
+      SDL_Rect area = dirty.get_area();
+
+      //Redraw only the invalid part and send only that to the window
+      SDL_SetClipRect(screen, &area);
+
+      //Apply the surface to the screen
+      apply_surface(0, 0, background, screen);
+      apply_surface(0, 150, message, screen);
+
+      if(caretOn == true)
       {
-        quit = true;
+        SDL_FillRect(screen, &caret, SDL_MapRGB(screen->format, 0xFF, 0xFF, 0xFF));
       }
+
+      SDL_SetClipRect(screen, NULL);
+      SDL_UpdateRect(screen, area.x, area.y, area.w, area.h);
+
+      dirty.clear();
+    }
+
+    //Sleep until something happens
+    if(SDL_WaitEvent(&event) == 0)
+    {
+      return 1;
+    }
+
+    //If the user has Xed out the window
+    if(event.type == SDL_QUIT)
+    {
+      quit = true;
+    }
+    else if(event.type == SDL_VIDEOEXPOSE)
+    {
+      dirty.invalidate_all();
+    }
+    else if((event.type == SDL_ACTIVEEVENT) && (event.active.gain == 1))
+    {
+      dirty.invalidate_all();
+    }
+    else if(event.type == SDL_USEREVENT)
+    {
+      caretOn = (!caretOn);
+      dirty.invalidate(caret);
     }
   }
 
+  SDL_RemoveTimer(caretTimer);
+
   //Free the surface and quit
   clean_up();
 